@@ -0,0 +1,59 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    /*
+     * Size of the file behind descriptor, so both paths are measured in bytes on disk.
+     */
+    uint64_t fileSize(int descriptor){
+        struct stat status;
+        fstat(descriptor, &status);
+        return status.st_size;
+    }
+}
+
+UNIT_BENCH_BEGIN("System::BinaryLog printf AsyncOutput")
+{
+    char path[] = "/tmp/wizardrtoz_textXXXXXX";
+    int descriptor = mkstemp(path);
+    auto* output = new System::AsyncOutputBuffer<1 << 20>(descriptor);
+    System::IOStream::attach(*output);
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        System::IOStream::printf("[%zu] sensor %d reading %d within the expected range\r\n", index, 3, static_cast<int>(index & 1023));
+        index++;
+    }
+    System::IOStream::detach();
+    delete output;
+    UNIT_BENCH_STATE.setCounter("bytes per entry", static_cast<double>(fileSize(descriptor)) / index);
+    close(descriptor);
+    unlink(path);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::BinaryLog BINARY_LOG AsyncOutput")
+{
+    char path[] = "/tmp/wizardrtoz_binaryXXXXXX";
+    int descriptor = mkstemp(path);
+    auto* output = new System::AsyncOutputBuffer<1 << 20>(descriptor);
+    uint64_t dropped = System::BinaryLog::getDropped();
+    System::BinaryLog::open(*output);
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        BINARY_LOG("[%zu] sensor %d reading %d within the expected range\r\n", index, 3, static_cast<int>(index & 1023));
+        index++;
+    }
+    System::BinaryLog::close();
+    delete output;
+    UNIT_BENCH_STATE.setCounter("bytes per entry", static_cast<double>(fileSize(descriptor)) / index);
+    UNIT_BENCH_STATE.setCounter("entries dropped", static_cast<double>(System::BinaryLog::getDropped() - dropped));
+    close(descriptor);
+    unlink(path);
+}
+UNIT_BENCH_END
@@ -0,0 +1,171 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <thread>
+
+namespace {
+    constexpr size_t batch_size = 32;
+
+    struct Frame{
+        uint64_t timestamp;
+        uint32_t producer;
+        uint8_t payload[52];
+    };
+
+    using FramePool = MemoryManager::MemoryPool<Frame, 1024>;
+    using FrameQueue = Communication::SPSCQueue<FramePool::Reference, 512>;
+
+    /*
+     * The pool is not thread safe, so frames travel to the consumer through one ring and
+     * come back to the producer through another one, which is where they are released. The
+     * measured statement sends batch frames; the consumer adds the latency of every frame.
+     */
+    void spsc(Bencher::State& state, size_t batch){
+        static FramePool pool;
+        static FrameQueue forward;
+        static FrameQueue backward;
+
+        state.spawn(1, [&state, batch](){
+            FramePool::Reference frames[batch_size];
+            while (state.isRunning()){
+                size_t amount = forward.pop(frames, batch);
+                if (amount == 0){
+                    std::this_thread::yield();
+                    continue;
+                }
+                uint64_t now = UnitTest::now();
+                for (size_t index = 0 ; index < amount ; index++){
+                    state.addLatency(now - frames[index].getData().timestamp);
+                }
+                size_t returned = 0;
+                while ((returned += backward.push(frames + returned, amount - returned)) < amount && state.isRunning()){
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        UnitTest::pin(0);
+        FramePool::Reference frames[batch_size];
+        FramePool::Reference recycled[batch_size];
+        auto recycle = [&recycled](){
+            while (backward.pop(recycled, batch_size) != 0){
+                for (auto& frame : recycled){
+                    frame.release();
+                }
+            }
+        };
+        while (state.keepRunning()){
+            size_t amount = 0;
+            while (amount < batch){
+                recycle();
+                size_t available = pool.getFreeSpace() < (batch - amount) ? pool.getFreeSpace() : (batch - amount);
+                for (size_t index = 0 ; index < available ; index++){
+                    frames[amount++] = pool.allocate();
+                }
+                if (amount < batch){
+                    std::this_thread::yield();
+                }
+            }
+            uint64_t now = UnitTest::now();
+            for (size_t index = 0 ; index < batch ; index++){
+                frames[index].getData().timestamp = now;
+            }
+            size_t queued = 0;
+            while ((queued += forward.push(frames + queued, batch - queued)) < batch){
+                std::this_thread::yield();
+            }
+        }
+
+        /*
+         * The consumer is joined: give back the frames left in both rings.
+         */
+        while (forward.pop(recycled, batch_size) != 0){
+            for (auto& frame : recycled){
+                frame.release();
+            }
+        }
+        recycle();
+    }
+
+    constexpr size_t amount_of_producers = 3;
+    constexpr size_t elements_per_producer = 256;
+
+    using FrameElement = Communication::MPSCQueue<FramePool::Reference>::Element;
+
+    struct Producer{
+        FramePool pool;
+        FrameElement elements[elements_per_producer];
+        Communication::SPSCQueue<FrameElement*, elements_per_producer> backward;
+    };
+}
+
+UNIT_BENCH_BEGIN("Communication::SPSCQueue push/pop")
+{
+    spsc(UNIT_BENCH_STATE, 1);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Communication::SPSCQueue push/pop, 32 frames per batch")
+{
+    spsc(UNIT_BENCH_STATE, batch_size);
+}
+UNIT_BENCH_END
+
+/*
+ * The measured statement is the consumer, receiving one frame from any of the producers.
+ */
+UNIT_BENCH_BEGIN("Communication::MPSCQueue pop, 3 producers")
+{
+    static Communication::MPSCQueue<FramePool::Reference> queue;
+    static Producer producers[amount_of_producers];
+    for (size_t id = 0 ; id < amount_of_producers ; id++){
+        UNIT_BENCH_STATE.spawn(id + 1, [&state = UNIT_BENCH_STATE, id](){
+            Producer& producer = producers[id];
+            FrameElement* available[elements_per_producer];
+            size_t amount_available = 0;
+            for (auto& element : producer.elements){
+                available[amount_available++] = &element;
+            }
+            while (state.isRunning()){
+                if (amount_available == 0 && (amount_available = producer.backward.pop(available, elements_per_producer)) == 0){
+                    std::this_thread::yield();
+                    continue;
+                }
+                FrameElement* element = available[--amount_available];
+                element->getData().release();
+                FramePool::Reference frame = producer.pool.allocate();
+                frame.getData().producer = id;
+                frame.getData().timestamp = UnitTest::now();
+                element->setData(std::move(frame));
+                queue.push(*element);
+            }
+        });
+    }
+
+    UnitTest::pin(0);
+    UNIT_BENCH_MEASURE {
+        FrameElement* element = queue.pop();
+        while (element == nullptr){
+            std::this_thread::yield();
+            element = queue.pop();
+        }
+        Frame& frame = element->getData().getData();
+        UNIT_BENCH_STATE.addLatency(UnitTest::now() - frame.timestamp);
+        producers[frame.producer].backward.push(element);
+    }
+
+    /*
+     * The producers are joined: empty the queue, then release every frame.
+     */
+    while (queue.pop() != nullptr){
+    }
+    for (auto& producer : producers){
+        FrameElement* element = nullptr;
+        while (producer.backward.pop(&element, 1) != 0){
+        }
+        for (auto& element : producer.elements){
+            element.getData().release();
+        }
+    }
+}
+UNIT_BENCH_END
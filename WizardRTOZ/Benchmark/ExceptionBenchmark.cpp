@@ -0,0 +1,120 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <functional>
+
+/*
+ * The check policy is fixed per build: rebuild with -DSYSTEM_CHECK_POLICY=assert_only or
+ * -DSYSTEM_CHECK_POLICY=none to compare the three of them.
+ */
+namespace {
+    constexpr size_t amount_of_bits = 4096;
+    constexpr size_t pool_size = 4096;
+    uint16_t positions[4096];   ///< Valid positions the compiler cannot prove valid
+
+    MemoryManager::BitArray<amount_of_bits> bit_array;
+    MemoryManager::MemoryPool<uint32_t, pool_size> pool;
+
+    /*
+     * The previous Exception::test, which built a std::function default argument on every call.
+     */
+    [[gnu::noinline]] bool legacyTest(bool condition, const char* message = nullptr, std::function<bool(System::Exception)> treatment_callback = [](System::Exception){ return false; }){
+        if (condition == false){
+            return true;
+        }
+        System::Exceptions::out_of_range.warning(message);
+        return treatment_callback(System::Exceptions::out_of_range);
+    }
+
+    /*
+     * Fill the bit array and positions once, and hand a reference over the whole pool.
+     */
+    MemoryManager::MemoryPool<uint32_t, pool_size>::Reference prepare(void){
+        for (size_t index = 0 ; index < amount_of_bits ; index += 3){
+            bit_array.set(index);
+        }
+        for (size_t index = 0 ; index < 4096 ; index++){
+            positions[index] = static_cast<uint16_t>((index * 2654435761u) >> 20) & 4095;
+        }
+        auto reference = pool.allocate(pool_size);
+        for (size_t index = 0 ; index < pool_size ; index++){
+            reference.setData(static_cast<uint32_t>(index), index);
+        }
+        return reference;
+    }
+}
+
+UNIT_BENCH_BEGIN("System::Exception BitArray::get")
+{
+    prepare();
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        UnitTest::doNotOptimize(bit_array.get(positions[index++ & 4095]));
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Exception BitArray::tryGet")
+{
+    prepare();
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        bool bit = false;
+        bit_array.tryGet(positions[index++ & 4095], bit);
+        UnitTest::doNotOptimize(bit);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Exception MemoryPool::getData")
+{
+    prepare();
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        UnitTest::doNotOptimize(pool.getData(positions[index++ & 4095]));
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Exception Reference::getData")
+{
+    auto reference = prepare();
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        UnitTest::doNotOptimize(reference.getData(positions[index++ & 4095]));
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Exception Reference::tryGetData")
+{
+    auto reference = prepare();
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        uint32_t* data = nullptr;
+        UnitTest::doNotOptimize(reference.tryGetData(data, positions[index++ & 4095]) == System::Status::ok ? *data : 0);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Exception Reference::begin (no check)")
+{
+    auto reference = prepare();
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        UnitTest::doNotOptimize(reference.begin()[positions[index++ & 4095]]);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Exception std::function check (previous)")
+{
+    auto reference = prepare();
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        size_t position = positions[index++ & 4095];
+        legacyTest(position >= pool_size, "Invalid position.");
+        UnitTest::doNotOptimize(reference.begin()[position]);
+    }
+}
+UNIT_BENCH_END
@@ -0,0 +1,105 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+namespace {
+
+    /*
+     * Converts the value of every iteration with convert(buffer, index), which returns the text size.
+     */
+    template <typename CONVERSION> void measure(Bencher::State& state, CONVERSION convert){
+        char buffer[System::Formatter::max_size];
+        size_t index = 0;
+        while (state.keepRunning()){
+            UnitTest::doNotOptimize(convert(buffer, index++));
+            UnitTest::clobberMemory();
+        }
+    }
+
+    /*
+     * The whole IOStream route, into an AsyncOutput writing to /dev/null.
+     */
+    template <typename PRINT> void measureStream(Bencher::State& state, PRINT print){
+        int null_descriptor = open("/dev/null", O_WRONLY);
+        auto* output = new System::AsyncOutputBuffer<1 << 20>(null_descriptor);
+        System::IOStream::attach(*output);
+        size_t index = 0;
+        while (state.keepRunning()){
+            print(static_cast<int>(index++));
+        }
+        System::IOStream::detach();
+        delete output;
+        close(null_descriptor);
+    }
+}
+
+UNIT_BENCH_BEGIN("System::Formatter snprintf %d")
+{
+    measure(UNIT_BENCH_STATE, [](char* buffer, size_t index){
+        return static_cast<size_t>(snprintf(buffer, System::Formatter::max_size, "%d", static_cast<int>(index * 2654435761u)));
+    });
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Formatter int")
+{
+    measure(UNIT_BENCH_STATE, [](char* buffer, size_t index){
+        return System::Formatter::format(buffer, static_cast<int>(index * 2654435761u));
+    });
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Formatter snprintf %016llx")
+{
+    measure(UNIT_BENCH_STATE, [](char* buffer, size_t index){
+        return static_cast<size_t>(snprintf(buffer, System::Formatter::max_size, "%016llx", static_cast<unsigned long long>(index) * 0x9E3779B97F4A7C15ull));
+    });
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Formatter uint64_t hex")
+{
+    System::FormatOptions hex;
+    hex.base = 16;
+    hex.width = 16;
+    hex.fill = '0';
+    measure(UNIT_BENCH_STATE, [&hex](char* buffer, size_t index){
+        return System::Formatter::format(buffer, static_cast<uint64_t>(index) * 0x9E3779B97F4A7C15ull, hex);
+    });
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Formatter snprintf %.2f")
+{
+    measure(UNIT_BENCH_STATE, [](char* buffer, size_t index){
+        return static_cast<size_t>(snprintf(buffer, System::Formatter::max_size, "%.2f", static_cast<float>(index) * 0.37f));
+    });
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Formatter float")
+{
+    measure(UNIT_BENCH_STATE, [](char* buffer, size_t index){
+        return System::Formatter::format(buffer, static_cast<float>(index) * 0.37f);
+    });
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Formatter IOStream::printf %d")
+{
+    measureStream(UNIT_BENCH_STATE, [](int value){
+        System::IOStream::printf("%d", value);
+    });
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Formatter IOStream << int")
+{
+    measureStream(UNIT_BENCH_STATE, [](int value){
+        System::printer << value;
+    });
+}
+UNIT_BENCH_END
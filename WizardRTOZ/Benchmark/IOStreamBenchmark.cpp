@@ -0,0 +1,68 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+namespace {
+
+    /*
+     * Logs one line per iteration with IOStream::printf.
+     */
+    void logLines(Bencher::State& state){
+        size_t index = 0;
+        while (state.keepRunning()){
+            System::IOStream::printf("[%zu] sensor %d reading %d within the expected range\r\n", index, 3, static_cast<int>(index & 1023));
+            index++;
+        }
+        System::IOStream::flush();
+    }
+
+    void logAsync(Bencher::State& state, System::OverflowPolicy policy){
+        int null_descriptor = open("/dev/null", O_WRONLY);
+        auto* output = new System::AsyncOutputBuffer<1 << 20>(null_descriptor, policy);
+        System::IOStream::attach(*output);
+        logLines(state);
+        System::IOStream::detach();
+        state.setCounter("bytes dropped", output->getDropped());
+        delete output;
+        close(null_descriptor);
+    }
+}
+
+/*
+ * The direct path writes to the standard output, which is pointed at /dev/null while it runs.
+ */
+UNIT_BENCH_BEGIN("System::IOStream printf StreamSink (stdout)")
+{
+    int null_descriptor = open("/dev/null", O_WRONLY);
+    System::IOStream::flush();
+    fflush(stdout);
+    int stdout_descriptor = dup(STDOUT_FILENO);
+    dup2(null_descriptor, STDOUT_FILENO);
+    logLines(UNIT_BENCH_STATE);
+    fflush(stdout);
+    dup2(stdout_descriptor, STDOUT_FILENO);
+    close(stdout_descriptor);
+    close(null_descriptor);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::IOStream printf AsyncOutput block")
+{
+    logAsync(UNIT_BENCH_STATE, System::OverflowPolicy::block);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::IOStream printf AsyncOutput drop")
+{
+    logAsync(UNIT_BENCH_STATE, System::OverflowPolicy::drop);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::IOStream printf AsyncOutput overwrite")
+{
+    logAsync(UNIT_BENCH_STATE, System::OverflowPolicy::overwrite);
+}
+UNIT_BENCH_END
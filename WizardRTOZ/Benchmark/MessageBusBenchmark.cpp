@@ -0,0 +1,116 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Frame{
+        uint64_t timestamp;
+        uint8_t payload[4096];
+    };
+
+    using Bus = Communication::MessageBus<Frame, 256, 64>;
+
+    /*
+     * The measured statement publishes one frame to amount_of_subscribers subscribers, drained
+     * by as many consumer threads as there are spare cores. Each consumer adds the latency of
+     * the frames of its first subscriber.
+     */
+    void fanOut(Bencher::State& state, size_t amount_of_subscribers){
+        static Bus bus;
+        Bus::Topic topic(64, Communication::DropPolicy::block);
+        std::vector<Bus::Subscriber*> subscribers;
+        for (size_t index = 0 ; index < amount_of_subscribers ; index++){
+            subscribers.push_back(new Bus::Subscriber(topic));
+        }
+
+        size_t amount_of_cores = std::thread::hardware_concurrency();
+        size_t amount_of_consumers = amount_of_cores > 1 ? amount_of_cores - 1 : 1;
+        amount_of_consumers = amount_of_consumers < amount_of_subscribers ? amount_of_consumers : amount_of_subscribers;
+        for (size_t id = 0 ; id < amount_of_consumers ; id++){
+            state.spawn(id + 1, [&state, &subscribers, id, amount_of_consumers, amount_of_subscribers](){
+                Bus::Message message;
+                while (state.isRunning()){
+                    bool idle = true;
+                    for (size_t index = id ; index < amount_of_subscribers ; index += amount_of_consumers){
+                        while (subscribers[index]->tryReceive(message)){
+                            if (id == 0 && index == 0){
+                                state.addLatency(UnitTest::now() - message->timestamp);
+                            }
+                            idle = false;
+                        }
+                    }
+                    message.release();
+                    if (idle){
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        UnitTest::pin(0);
+        while (state.keepRunning()){
+            Bus::Message message = bus.allocate();
+            while (message.isEmpty()){
+                std::this_thread::yield();
+                message = bus.allocate();
+            }
+            message->timestamp = UnitTest::now();
+            topic.publish(message);
+        }
+        state.setCounter("deliveries per message", amount_of_subscribers);
+
+        /*
+         * The consumers are joined: give the frames still queued back to the bus.
+         */
+        Bus::Message message;
+        for (auto* subscriber : subscribers){
+            while (subscriber->tryReceive(message)){
+            }
+            delete subscriber;
+        }
+    }
+}
+
+UNIT_BENCH_BEGIN("Communication::MessageBus publish, 1 subscriber")
+{
+    fanOut(UNIT_BENCH_STATE, 1);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Communication::MessageBus publish, 2 subscribers")
+{
+    fanOut(UNIT_BENCH_STATE, 2);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Communication::MessageBus publish, 4 subscribers")
+{
+    fanOut(UNIT_BENCH_STATE, 4);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Communication::MessageBus publish, 8 subscribers")
+{
+    fanOut(UNIT_BENCH_STATE, 8);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Communication::MessageBus publish, 16 subscribers")
+{
+    fanOut(UNIT_BENCH_STATE, 16);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Communication::MessageBus publish, 32 subscribers")
+{
+    fanOut(UNIT_BENCH_STATE, 32);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Communication::MessageBus publish, 64 subscribers")
+{
+    fanOut(UNIT_BENCH_STATE, 64);
+}
+UNIT_BENCH_END
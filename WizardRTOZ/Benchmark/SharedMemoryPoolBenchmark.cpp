@@ -0,0 +1,138 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr size_t message_size = 4096;
+    constexpr uint64_t stop = UINT64_MAX;
+
+    using Pool = MemoryManager::SharedMemoryPool<uint8_t, 1 << 20>;
+
+    /*
+     * One slot mailbox between the two processes. offset holds position + 1 of the block in
+     * flight, 0 when the consumer is done with it, stop when the consumer has to exit.
+     */
+    struct Mailbox{
+        std::atomic<uint64_t> offset;
+    };
+
+    inline uint64_t checksum(const uint8_t* data, size_t size){
+        uint64_t sum = 0;
+        for (size_t index = 0 ; index < size ; index++){
+            sum += data[index];
+        }
+        return sum;
+    }
+}
+
+/*
+ * The producer fills a block and sends its offset, the consumer process reads the block where
+ * it is, frees it and answers by clearing the mailbox.
+ */
+UNIT_BENCH_BEGIN("MemoryManager::SharedMemoryPool offset handoff (4 KiB)")
+{
+    Pool* pool = new Pool();
+    Mailbox* mailbox = static_cast<Mailbox*>(mmap(nullptr, sizeof(Mailbox), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+    mailbox->offset.store(0, std::memory_order_relaxed);
+
+    System::IOStream::flush();
+    pid_t process = fork();
+    if (process == 0){
+        uint64_t sum = 0;
+        while (true){
+            uint64_t position = 0;
+            while ((position = mailbox->offset.load(std::memory_order_acquire)) == 0){
+                std::this_thread::yield();
+            }
+            if (position == stop){
+                break;
+            }
+            Pool::Offset offset {position - 1, message_size};
+            sum += checksum(pool->resolve(offset), message_size);
+            pool->free(offset);
+            mailbox->offset.store(0, std::memory_order_release);
+        }
+        _exit(sum == 0 ? 1 : 0);
+    }
+
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        Pool::Reference block = pool->allocate(message_size);
+        memset(block.begin(), static_cast<int>(index++ | 1), message_size);
+        mailbox->offset.store(block.detach().position + 1, std::memory_order_release);
+        while (mailbox->offset.load(std::memory_order_acquire) != 0){
+            std::this_thread::yield();
+        }
+    }
+    mailbox->offset.store(stop, std::memory_order_release);
+    waitpid(process, nullptr, 0);
+    munmap(mailbox, sizeof(Mailbox));
+    delete pool;
+}
+UNIT_BENCH_END
+
+/*
+ * The same round trip, copying the block through a pipe and answering with one byte.
+ */
+UNIT_BENCH_BEGIN("MemoryManager::SharedMemoryPool pipe copy (4 KiB)")
+{
+    int request[2];
+    int answer[2];
+    if (pipe(request) != 0 || pipe(answer) != 0){
+        return;
+    }
+    System::IOStream::flush();
+    pid_t process = fork();
+    if (process == 0){
+        close(request[1]);
+        close(answer[0]);
+        std::vector<uint8_t> buffer(message_size);
+        uint64_t sum = 0;
+        while (true){
+            size_t received = 0;
+            while (received < message_size){
+                ssize_t size = read(request[0], buffer.data() + received, message_size - received);
+                if (size <= 0){
+                    _exit(sum == 0 ? 1 : 0);
+                }
+                received += size;
+            }
+            sum += checksum(buffer.data(), message_size);
+            char acknowledge = 0;
+            if (write(answer[1], &acknowledge, 1) != 1){
+                _exit(1);
+            }
+        }
+    }
+    close(request[0]);
+    close(answer[1]);
+
+    std::vector<uint8_t> buffer(message_size);
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        memset(buffer.data(), static_cast<int>(index++ | 1), message_size);
+        size_t sent = 0;
+        while (sent < message_size){
+            ssize_t size = write(request[1], buffer.data() + sent, message_size - sent);
+            if (size <= 0){
+                break;
+            }
+            sent += size;
+        }
+        char acknowledge = 0;
+        if (read(answer[0], &acknowledge, 1) != 1){
+            break;
+        }
+    }
+    close(request[1]);
+    close(answer[0]);
+    waitpid(process, nullptr, 0);
+}
+UNIT_BENCH_END
@@ -0,0 +1,134 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr size_t capacity = 1 << 16;
+    constexpr size_t amount_of_lookups = 1 << 20;
+
+    struct Entity{
+        float position[3];
+        float velocity[3];
+        uint32_t id;
+        uint32_t flags;
+    };
+
+    using Pool = MemoryManager::MemoryPool<Entity, capacity>;
+    using Map = MemoryManager::SlotMap<Entity, capacity>;
+
+    /*
+     * Both containers are filled, then every other entity is erased in a random order, so the
+     * live entries are scattered the way they are after some churn. lookups holds random
+     * indexes of the live entities.
+     */
+    struct Fixture{
+        Pool* pool {new Pool()};
+        Map* map {new Map()};
+        std::vector<Pool::Reference> references;
+        std::vector<Entity*> pointers;
+        std::vector<Map::Handle> live_handles;
+        std::vector<uint32_t> lookups;
+
+        Fixture(void) : references(capacity), lookups(amount_of_lookups) {
+            std::mt19937 random(1234);
+            std::vector<size_t> order(capacity);
+            for (size_t index = 0 ; index < capacity ; index++){
+                order[index] = index;
+            }
+            std::shuffle(order.begin(), order.end(), random);
+
+            /*
+             * MemoryPool: entities are pointed at through References, kept in a table of pointers.
+             */
+            for (size_t index = 0 ; index < capacity ; index++){
+                this->references[index] = this->pool->allocate(1);
+                this->references[index].getData().id = static_cast<uint32_t>(index);
+            }
+            for (size_t index : order){
+                if (index & 1){
+                    this->references[index].release();
+                } else {
+                    this->pointers.push_back(this->references[index].begin());
+                }
+            }
+
+            /*
+             * SlotMap: the same entities, reached through handles.
+             */
+            std::vector<Map::Handle> handles(capacity);
+            for (size_t index = 0 ; index < capacity ; index++){
+                handles[index] = this->map->insert(Entity {{0, 0, 0}, {1, 1, 1}, static_cast<uint32_t>(index), 0});
+            }
+            for (size_t index : order){
+                if (index & 1){
+                    this->map->erase(handles[index]);
+                } else {
+                    this->live_handles.push_back(handles[index]);
+                }
+            }
+            for (uint32_t& lookup : this->lookups){
+                lookup = static_cast<uint32_t>(random() % this->pointers.size());
+            }
+        }
+        ~Fixture(void){
+            this->references.clear();
+            delete this->map;
+            delete this->pool;
+        }
+    };
+}
+
+/*
+ * An iteration moves all of the 32768 live entities.
+ */
+UNIT_BENCH_BEGIN("MemoryManager::SlotMap iterate MemoryPool through pointers")
+{
+    Fixture fixture;
+    UNIT_BENCH_MEASURE {
+        for (Entity* entity : fixture.pointers){
+            for (size_t axis = 0 ; axis < 3 ; axis++){
+                entity->position[axis] += entity->velocity[axis];
+            }
+        }
+        UnitTest::clobberMemory();
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::SlotMap iterate dense values")
+{
+    Fixture fixture;
+    UNIT_BENCH_MEASURE {
+        for (Entity& entity : *fixture.map){
+            for (size_t axis = 0 ; axis < 3 ; axis++){
+                entity.position[axis] += entity.velocity[axis];
+            }
+        }
+        UnitTest::clobberMemory();
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::SlotMap lookup MemoryPool pointer (unchecked)")
+{
+    Fixture fixture;
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        UnitTest::doNotOptimize(fixture.pointers[fixture.lookups[index++ & (amount_of_lookups - 1)]]->id);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::SlotMap lookup handle (generation checked)")
+{
+    Fixture fixture;
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        Entity* entity = fixture.map->get(fixture.live_handles[fixture.lookups[index++ & (amount_of_lookups - 1)]]);
+        UnitTest::doNotOptimize(entity == nullptr ? 0 : entity->id);
+    }
+}
+UNIT_BENCH_END
@@ -0,0 +1,134 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    constexpr size_t pool_size = size_t(1) << 30;
+    constexpr size_t block_size = size_t(1) << 20;
+    constexpr size_t amount_of_blocks = 512;
+    constexpr size_t amount_of_samples = 5;
+    constexpr const char* path = "/tmp/wizardrtoz-snapshot-benchmark";
+
+    using Pool = MemoryManager::MemoryPool<uint8_t, pool_size>;
+    using Snapshot = MemoryManager::Snapshot<Pool>;
+
+    /*
+     * Build a new pool as a cold start does: half of it allocated and written.
+     */
+    Snapshot* build(std::vector<size_t>& positions){
+        unlink(path);
+        Snapshot* snapshot = new Snapshot(path);
+        snapshot->attach();
+        positions.clear();
+        for (size_t index = 0 ; index < amount_of_blocks ; index++){
+            Pool::Reference reference = (*snapshot)->allocate(block_size);
+            memset(reference.begin(), static_cast<int>(index % 200 + 1), block_size);
+            positions.push_back(reference.getPosition());
+            reference.detach();
+        }
+        return snapshot;
+    }
+
+    /*
+     * Write the snapshot of a built pool and reopen it as a warm restart does, without timing it.
+     */
+    Snapshot* reopen(Bencher::State& state, Snapshot* snapshot){
+        state.pauseTiming();
+        snapshot->snapshot();
+        delete snapshot;
+        state.resumeTiming();
+        return new Snapshot(path);
+    }
+
+    void warmStart(Bencher::State& state, bool verify){
+        std::vector<size_t> positions;
+        Snapshot* snapshot = build(positions);
+        bool restored = true;
+        state.setAmountOfSamples(amount_of_samples);
+        while (state.keepRunning()){
+            snapshot = reopen(state, snapshot);
+            restored = snapshot->attach(verify) && restored;
+        }
+        state.setCounter("restored", restored);
+        delete snapshot;
+        unlink(path);
+    }
+}
+
+/*
+ * A 1 GiB pool, half of it allocated and written, is built from scratch as a cold start does,
+ * then restored from its snapshot as a warm restart does. The file stays in the page cache, so
+ * the warm numbers do not include reading it from the disk.
+ */
+UNIT_BENCH_BEGIN("MemoryManager::Snapshot cold start (construct and fill)")
+{
+    std::vector<size_t> positions;
+    Snapshot* snapshot = nullptr;
+    UNIT_BENCH_STATE.setAmountOfSamples(amount_of_samples);
+    UNIT_BENCH_MEASURE {
+        UNIT_BENCH_STATE.pauseTiming();
+        delete snapshot;
+        UNIT_BENCH_STATE.resumeTiming();
+        snapshot = build(positions);
+    }
+    delete snapshot;
+    unlink(path);
+}
+UNIT_BENCH_END
+
+/*
+ * Every iteration writes one block again before the snapshot.
+ */
+UNIT_BENCH_BEGIN("MemoryManager::Snapshot snapshot()")
+{
+    std::vector<size_t> positions;
+    Snapshot* snapshot = build(positions);
+    size_t index = 0;
+    UNIT_BENCH_STATE.setAmountOfSamples(amount_of_samples);
+    UNIT_BENCH_MEASURE {
+        UNIT_BENCH_STATE.pauseTiming();
+        Pool::Reference reference = (*snapshot)->adopt(positions[index % amount_of_blocks], block_size);
+        memset(reference.begin(), static_cast<int>(index++ % 200 + 1), block_size);
+        reference.detach();
+        UNIT_BENCH_STATE.resumeTiming();
+        snapshot->snapshot();
+    }
+    delete snapshot;
+    unlink(path);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::Snapshot warm start (attach)")
+{
+    warmStart(UNIT_BENCH_STATE, false);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::Snapshot warm start (attach, checksum verified)")
+{
+    warmStart(UNIT_BENCH_STATE, true);
+}
+UNIT_BENCH_END
+
+/*
+ * The attach and the first read of a block in the middle of the pool, faulted in from the file.
+ */
+UNIT_BENCH_BEGIN("MemoryManager::Snapshot warm start and first access")
+{
+    std::vector<size_t> positions;
+    Snapshot* snapshot = build(positions);
+    UNIT_BENCH_STATE.setAmountOfSamples(amount_of_samples);
+    UNIT_BENCH_MEASURE {
+        snapshot = reopen(UNIT_BENCH_STATE, snapshot);
+        snapshot->attach();
+        Pool::Reference reference = (*snapshot)->adopt(positions[amount_of_blocks / 2], block_size);
+        UnitTest::doNotOptimize(reference.getData(block_size - 1));
+        reference.detach();
+    }
+    delete snapshot;
+    unlink(path);
+}
+UNIT_BENCH_END
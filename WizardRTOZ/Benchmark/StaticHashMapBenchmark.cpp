@@ -0,0 +1,216 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    constexpr size_t capacity = 1 << 16;
+    constexpr size_t amount_of_lookups = 1 << 20;
+
+    using Map = MemoryManager::StaticHashMap<uint64_t, uint64_t, capacity>;
+
+    /*
+     * The keys filling a map to load, and stored keys and absent keys in a random order.
+     */
+    struct Keys{
+        std::vector<uint64_t> keys;
+        std::vector<uint64_t> hits;
+        std::vector<uint64_t> misses;
+
+        Keys(double load) : keys(static_cast<size_t>(capacity * load)), hits(amount_of_lookups), misses(amount_of_lookups) {
+            std::mt19937_64 random(load * 1000);
+            for (uint64_t& key : this->keys){
+                key = random();
+            }
+            for (size_t index = 0 ; index < amount_of_lookups ; index++){
+                this->hits[index] = this->keys[random() % this->keys.size()];
+                this->misses[index] = random();
+            }
+        }
+    };
+
+    /*
+     * An iteration inserts the next key; the map is cleared when all of them are in, so it
+     * never goes past load. The clear is amortized over the keys.
+     */
+    void insertStatic(Bencher::State& state, double load){
+        Keys keys(load);
+        Map* map = new Map();
+        size_t index = 0;
+        while (state.keepRunning()){
+            if (index == keys.keys.size()){
+                map->clear();
+                index = 0;
+            }
+            map->insert(keys.keys[index], keys.keys[index]);
+            index++;
+        }
+        delete map;
+    }
+
+    void insertStandard(Bencher::State& state, double load){
+        Keys keys(load);
+        std::unordered_map<uint64_t, uint64_t> map;
+        map.reserve(keys.keys.size());
+        size_t index = 0;
+        while (state.keepRunning()){
+            if (index == keys.keys.size()){
+                map.clear();
+                index = 0;
+            }
+            map[keys.keys[index]] = keys.keys[index];
+            index++;
+        }
+    }
+
+    /*
+     * Fill the map to load, then look up the hits (or the misses) in turn.
+     */
+    void findStatic(Bencher::State& state, double load, bool hit){
+        Keys keys(load);
+        Map* map = new Map();
+        for (uint64_t key : keys.keys){
+            map->insert(key, key);
+        }
+        size_t index = 0;
+        if (hit){
+            while (state.keepRunning()){
+                UnitTest::doNotOptimize(*map->find(keys.hits[index++ & (amount_of_lookups - 1)]));
+            }
+        } else {
+            while (state.keepRunning()){
+                UnitTest::doNotOptimize(map->contains(keys.misses[index++ & (amount_of_lookups - 1)]));
+            }
+        }
+        delete map;
+    }
+
+    void findStandard(Bencher::State& state, double load, bool hit){
+        Keys keys(load);
+        std::unordered_map<uint64_t, uint64_t> map;
+        map.reserve(keys.keys.size());
+        for (uint64_t key : keys.keys){
+            map[key] = key;
+        }
+        size_t index = 0;
+        if (hit){
+            while (state.keepRunning()){
+                UnitTest::doNotOptimize(map.find(keys.hits[index++ & (amount_of_lookups - 1)])->second);
+            }
+        } else {
+            while (state.keepRunning()){
+                UnitTest::doNotOptimize(map.count(keys.misses[index++ & (amount_of_lookups - 1)]));
+            }
+        }
+    }
+}
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap insert, 50% load")
+{
+    insertStatic(UNIT_BENCH_STATE, 0.5);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map insert, 50% load")
+{
+    insertStandard(UNIT_BENCH_STATE, 0.5);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap hit, 50% load")
+{
+    findStatic(UNIT_BENCH_STATE, 0.5, true);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map hit, 50% load")
+{
+    findStandard(UNIT_BENCH_STATE, 0.5, true);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap miss, 50% load")
+{
+    findStatic(UNIT_BENCH_STATE, 0.5, false);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map miss, 50% load")
+{
+    findStandard(UNIT_BENCH_STATE, 0.5, false);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap insert, 70% load")
+{
+    insertStatic(UNIT_BENCH_STATE, 0.7);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map insert, 70% load")
+{
+    insertStandard(UNIT_BENCH_STATE, 0.7);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap hit, 70% load")
+{
+    findStatic(UNIT_BENCH_STATE, 0.7, true);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map hit, 70% load")
+{
+    findStandard(UNIT_BENCH_STATE, 0.7, true);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap miss, 70% load")
+{
+    findStatic(UNIT_BENCH_STATE, 0.7, false);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map miss, 70% load")
+{
+    findStandard(UNIT_BENCH_STATE, 0.7, false);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap insert, 90% load")
+{
+    insertStatic(UNIT_BENCH_STATE, 0.9);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map insert, 90% load")
+{
+    insertStandard(UNIT_BENCH_STATE, 0.9);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap hit, 90% load")
+{
+    findStatic(UNIT_BENCH_STATE, 0.9, true);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map hit, 90% load")
+{
+    findStandard(UNIT_BENCH_STATE, 0.9, true);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap miss, 90% load")
+{
+    findStatic(UNIT_BENCH_STATE, 0.9, false);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StaticHashMap std::unordered_map miss, 90% load")
+{
+    findStandard(UNIT_BENCH_STATE, 0.9, false);
+}
+UNIT_BENCH_END
@@ -0,0 +1,121 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <vector>
+
+namespace {
+    constexpr size_t amount_of_particles = 1 << 16;
+
+    struct Particle{
+        float position[3];
+        float velocity[3];
+        float mass;
+        uint32_t id;
+    };
+
+    enum Field { x, y, z, vx, vy, vz, mass, id };
+    using Pool = MemoryManager::MemoryPool<Particle, amount_of_particles>;
+    using Table = MemoryManager::StructOfArrays<amount_of_particles, float, float, float, float, float, float, float, uint32_t>;
+
+    /*
+     * Every layout runs this kernel, product(index) being mass * vx of row index. A float sum
+     * is only vectorized when reassociation is allowed (-ffast-math), so the bulk of the rows
+     * is summed in eight lanes, each one in order: the compiler may keep them in one vector
+     * register under the default flags when the layout lets it load eight rows at once.
+     */
+    template <typename PRODUCT> inline float momentum(size_t size, PRODUCT product){
+        float lanes[8] = {};
+        size_t bulk = size & ~size_t(7);
+        for (size_t index = 0 ; index < bulk ; index += 8){
+            for (size_t lane = 0 ; lane < 8 ; lane++){
+                lanes[lane] += product(index + lane);
+            }
+        }
+        float sum = 0;
+        for (size_t index = bulk ; index < size ; index++){
+            sum += product(index);
+        }
+        for (size_t lane = 0 ; lane < 8 ; lane++){
+            sum += lanes[lane];
+        }
+        return sum;
+    }
+
+    /*
+     * The same particles in both layouts.
+     */
+    struct Fixture{
+        Pool* pool {new Pool()};
+        Table* table {new Table()};
+        std::vector<Pool::Reference> references;
+
+        Fixture(void) : references(amount_of_particles) {
+            for (size_t index = 0 ; index < amount_of_particles ; index++){
+                float value = static_cast<float>(index & 255);
+                this->references[index] = this->pool->allocate(1);
+                this->references[index].setData(Particle {{value, value, value}, {value, 1, 1}, 2, static_cast<uint32_t>(index)});
+                this->table->append(value, value, value, value, 1, 1, 2, static_cast<uint32_t>(index));
+            }
+        }
+        ~Fixture(void){
+            this->references.clear();
+            delete this->table;
+            delete this->pool;
+        }
+    };
+}
+
+/*
+ * The reduction is the total momentum along x, sum(mass * vx): two of the eight fields of every
+ * particle. Every case runs the same momentum kernel over the 65536 particles per iteration, so
+ * the numbers differ by the layout and the accessors only.
+ */
+UNIT_BENCH_BEGIN("MemoryManager::StructOfArrays AoS Reference::getData")
+{
+    Fixture fixture;
+    UNIT_BENCH_MEASURE {
+        UnitTest::doNotOptimize(momentum(amount_of_particles, [&fixture](size_t index){
+            const Particle& particle = fixture.references[index].getData();
+            return particle.mass * particle.velocity[0];
+        }));
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StructOfArrays AoS MemoryPool raw array")
+{
+    Fixture fixture;
+    UNIT_BENCH_MEASURE {
+        const Particle* __restrict particles = fixture.pool->begin();
+        UnitTest::doNotOptimize(momentum(amount_of_particles, [particles](size_t index){
+            return particles[index].mass * particles[index].velocity[0];
+        }));
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StructOfArrays SoA column spans")
+{
+    Fixture fixture;
+    UNIT_BENCH_MEASURE {
+        const float* __restrict masses = fixture.table->getColumn<mass>().begin();
+        const float* __restrict velocities = fixture.table->getColumn<vx>().begin();
+        UnitTest::doNotOptimize(momentum(fixture.table->getSize(), [masses, velocities](size_t index){
+            return masses[index] * velocities[index];
+        }));
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryManager::StructOfArrays SoA rows")
+{
+    Fixture fixture;
+    Table& table = *fixture.table;
+    UNIT_BENCH_MEASURE {
+        UnitTest::doNotOptimize(momentum(table.getSize(), [&table](size_t index){
+            auto row = table[index];
+            return row.get<mass>() * row.get<vx>();
+        }));
+    }
+}
+UNIT_BENCH_END
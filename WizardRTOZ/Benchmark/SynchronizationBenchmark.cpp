@@ -0,0 +1,149 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /*
+     * The measured statement increments a shared counter inside a short critical section,
+     * while amount_of_threads - 1 other threads do the same.
+     */
+    template <typename MUTEX_TYPE> void contend(Bencher::State& state, MUTEX_TYPE& mutex, size_t amount_of_threads){
+        static volatile uint64_t counter = 0;
+        for (size_t id = 1 ; id < amount_of_threads ; id++){
+            state.spawn(id, [&state, &mutex](){
+                while (state.isRunning()){
+                    mutex.lock();
+                    counter = counter + 1;
+                    mutex.unlock();
+                }
+            });
+        }
+        UnitTest::pin(0);
+        while (state.keepRunning()){
+            mutex.lock();
+            counter = counter + 1;
+            mutex.unlock();
+        }
+    }
+
+    void contendStandard(Bencher::State& state, size_t amount_of_threads){
+        std::mutex mutex;
+        contend(state, mutex, amount_of_threads);
+    }
+
+    void contendMutex(Bencher::State& state, size_t amount_of_threads){
+        Synchronization::Mutex mutex;
+        contend(state, mutex, amount_of_threads);
+        Synchronization::ContentionCounters counters = mutex.getContentionCounters();
+        state.setCounter("spun", counters.spun);
+        state.setCounter("parked", counters.parked);
+    }
+}
+
+UNIT_BENCH_BEGIN("Synchronization std::mutex, 1 thread")
+{
+    contendStandard(UNIT_BENCH_STATE, 1);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Synchronization::Mutex, 1 thread")
+{
+    contendMutex(UNIT_BENCH_STATE, 1);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Synchronization std::mutex, 2 threads")
+{
+    contendStandard(UNIT_BENCH_STATE, 2);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Synchronization::Mutex, 2 threads")
+{
+    contendMutex(UNIT_BENCH_STATE, 2);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Synchronization std::mutex, 4 threads")
+{
+    contendStandard(UNIT_BENCH_STATE, 4);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Synchronization::Mutex, 4 threads")
+{
+    contendMutex(UNIT_BENCH_STATE, 4);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Synchronization std::mutex, 8 threads")
+{
+    contendStandard(UNIT_BENCH_STATE, 8);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Synchronization::Mutex, 8 threads")
+{
+    contendMutex(UNIT_BENCH_STATE, 8);
+}
+UNIT_BENCH_END
+
+/*
+ * The measured statement hands a token to a consumer through a bounded pair of semaphores.
+ */
+UNIT_BENCH_BEGIN("Synchronization::Semaphore bounded handoff")
+{
+    Synchronization::Semaphore items(0);
+    Synchronization::Semaphore slots(64);
+    std::vector<uint64_t> timestamps(64);
+    UNIT_BENCH_STATE.spawn(1, [&state = UNIT_BENCH_STATE, &items, &slots, &timestamps](){
+        for (size_t index = 0 ; ; index++){
+            items.acquire();
+            if (state.isRunning() == false){
+                break;
+            }
+            state.addLatency(UnitTest::now() - timestamps[index & 63]);
+            slots.release();
+        }
+    }, [&items](){
+        items.release();
+    });
+    UnitTest::pin(0);
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        slots.acquire();
+        timestamps[index++ & 63] = UnitTest::now();
+        items.release();
+    }
+    Synchronization::ContentionCounters counters = items.getContentionCounters();
+    UNIT_BENCH_STATE.setCounter("spun", counters.spun);
+    UNIT_BENCH_STATE.setCounter("parked", counters.parked);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Synchronization::EventFlags round trip")
+{
+    Synchronization::EventFlags request;
+    Synchronization::EventFlags response;
+    UNIT_BENCH_STATE.spawn(1, [&state = UNIT_BENCH_STATE, &request, &response](){
+        while (true){
+            request.wait(1, Synchronization::EventFlags::Mode::any, true);
+            if (state.isRunning() == false){
+                break;
+            }
+            response.set(1);
+        }
+    }, [&request](){
+        request.set(1);
+    });
+    UnitTest::pin(0);
+    UNIT_BENCH_MEASURE {
+        request.set(1);
+        response.wait(1, Synchronization::EventFlags::Mode::any, true);
+    }
+}
+UNIT_BENCH_END
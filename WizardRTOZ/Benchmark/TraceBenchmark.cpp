@@ -0,0 +1,77 @@
+#include "../UnitTest/UnitTest.h"
+#include "../WizardRTOZ/WizardRTOZ.h"
+
+/*
+ * Rebuild with -DSYSTEM_TRACE=0 to measure the instrumented paths compiled out.
+ */
+namespace {
+    void allocateAndFree(Bencher::State& state){
+        static MemoryManager::MemoryPool<uint64_t, 64> pool;
+        size_t index = 0;
+        while (state.keepRunning()){
+            auto reference = pool.allocate(1 + (index & 3));
+            reference.setData(index++);
+        }
+    }
+}
+
+UNIT_BENCH_BEGIN("System::Trace allocate/free, stopped")
+{
+    allocateAndFree(UNIT_BENCH_STATE);
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Trace allocate/free, recording")
+{
+    System::Trace::start();
+    allocateAndFree(UNIT_BENCH_STATE);
+    System::Trace::stop();
+    System::Trace::clear();
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Trace empty TRACE_ZONE, recording")
+{
+    System::Trace::start();
+    UNIT_BENCH_MEASURE {
+        TRACE_ZONE("zone");
+    }
+    System::Trace::stop();
+    System::Trace::clear();
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("System::Trace TRACE_COUNTER, recording")
+{
+    System::Trace::start();
+    size_t index = 0;
+    UNIT_BENCH_MEASURE {
+        TRACE_COUNTER("counter", index++);
+    }
+    System::Trace::stop();
+    System::Trace::clear();
+}
+UNIT_BENCH_END
+
+/*
+ * Every iteration exports the same recording, made of 1 << 16 zones.
+ */
+UNIT_BENCH_BEGIN("System::Trace exportChrome")
+{
+    System::Trace::start();
+    for (size_t index = 0 ; index < (1 << 16) ; index++){
+        TRACE_ZONE("zone");
+    }
+    System::Trace::stop();
+    System::MemorySink sink;
+    size_t amount_of_events = 0;
+    UNIT_BENCH_STATE.setAmountOfSamples(11);
+    UNIT_BENCH_MEASURE {
+        sink.clear();
+        amount_of_events = System::Trace::exportChrome(sink);
+    }
+    UNIT_BENCH_STATE.setCounter("events", amount_of_events);
+    UNIT_BENCH_STATE.setCounter("bytes", sink.getSize());
+    System::Trace::clear();
+}
+UNIT_BENCH_END
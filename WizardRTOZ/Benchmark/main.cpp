@@ -0,0 +1,41 @@
+#include "../UnitTest/UnitTest.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Arguments: a substring of the benchmark names to run, --json <path> to write the results and
+ * --baseline <path> to compare them with a previous --json file.
+ */
+int main(int argc, char** argv)
+{
+    const char* filter = nullptr;
+    const char* json_path = nullptr;
+    const char* baseline_path = nullptr;
+    for (int index = 1 ; index < argc ; index++){
+        if (strcmp(argv[index], "--json") == 0 && index + 1 < argc){
+            json_path = argv[++index];
+        } else if (strcmp(argv[index], "--baseline") == 0 && index + 1 < argc){
+            baseline_path = argv[++index];
+        } else {
+            filter = argv[index];
+        }
+    }
+
+    int json_descriptor = -1;
+    if (json_path != nullptr){
+        json_descriptor = open(json_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (json_descriptor < 0){
+            UnitTest::log("[x] Could not open %s.\r\n", json_path);
+            return 1;
+        }
+    }
+    System::FileSink json(json_descriptor);
+    size_t regressions = UnitTest::bench(filter, json_descriptor < 0 ? nullptr : &json, baseline_path);
+    if (json_descriptor >= 0){
+        close(json_descriptor);
+    }
+    return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#include "../WizardRTOZ/System/BinaryLog.h"
+
+#include <stdio.h>
+#include <vector>
+
+/*
+ * Usage: BinaryLogDecoder [dump file]
+ *
+ * Turns a System::BinaryLog dump (or stdin) back into text on stdout.
+ */
+int main(int argc, char** argv)
+{
+    FILE* input = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (input == nullptr){
+        fprintf(stderr, "[x] Could not open %s\r\n", argv[1]);
+        return 1;
+    }
+    std::vector<uint8_t> dump;
+    uint8_t buffer[1 << 16];
+    size_t size = 0;
+    while ((size = fread(buffer, 1, sizeof(buffer), input)) > 0){
+        dump.insert(dump.end(), buffer, buffer + size);
+    }
+    if (input != stdin){
+        fclose(input);
+    }
+
+    size_t decoded = System::BinaryLog::decode(dump.data(), dump.size(), [](const char* text, size_t text_size){
+        fwrite(text, 1, text_size, stdout);
+    });
+    if (decoded != dump.size()){
+        fprintf(stderr, "[!] %zu trailing bytes could not be decoded.\r\n", dump.size() - decoded);
+        return 2;
+    }
+    return 0;
+}
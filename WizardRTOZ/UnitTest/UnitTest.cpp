@@ -1,12 +1,88 @@
 #include "./UnitTest.h"
+#include "../WizardRTOZ/System/Exception.h"
 #include <stdarg.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 Tester* UnitTest::first = nullptr;
 Tester* UnitTest::last = nullptr;
-std::function<void(char)> UnitTest::write_function = nullptr;
+Bencher* UnitTest::first_bencher = nullptr;
+Bencher* UnitTest::last_bencher = nullptr;
+System::Sink* UnitTest::sink = nullptr;
 
-Tester::Tester(std::function<bool(void)> test_function) : test_function(test_function) {
+namespace {
+    /*
+     * Median of the benchmark name in a JSON written by UnitTest::bench, 0 when it is not there.
+     */
+    double baselineMedian(const std::string& baseline, const char* name){
+        std::string key = std::string("{\"name\":\"") + name + "\"";
+        size_t position = baseline.find(key);
+        if (position == std::string::npos){
+            return 0;
+        }
+        size_t line_end = baseline.find('\n', position);
+        position = baseline.find("\"median_ns\":", position);
+        if (position == std::string::npos || position > line_end){
+            return 0;
+        }
+        return strtod(baseline.c_str() + position + strlen("\"median_ns\":"), nullptr);
+    }
+
+    const char* checkPolicyName(void){
+        switch (System::check_policy){
+            case System::CheckPolicy::full: return "full";
+            case System::CheckPolicy::assert_only: return "assert_only";
+            default: return "none";
+        }
+    }
+
+    /*
+     * A test running in its own process, which writes its log to the pipe read by descriptor.
+     */
+    struct Worker{
+        Tester* tester {nullptr};
+        pid_t process {-1};
+        int descriptor {-1};
+        uint64_t begin {0};
+        bool timed_out {false};
+        std::string output;
+    };
+
+    /*
+     * vsnprintf into buffer, or into text when the message does not fit, as IOStream::printf does.
+     */
+    size_t format(char* buffer, size_t buffer_size, std::string& text, const char*& formatted, const char* message, va_list arguments){
+        va_list copy;
+        va_copy(copy, arguments);
+        int length = vsnprintf(buffer, buffer_size, message, copy);
+        va_end(copy);
+        formatted = buffer;
+        if (length <= 0){
+            return 0;
+        }
+        if (static_cast<size_t>(length) >= buffer_size){
+            text.resize(length + 1);
+            vsnprintf(&text[0], length + 1, message, arguments);
+            formatted = text.c_str();
+        }
+        return length;
+    }
+}
+
+Tester::Tester(const char* file, int line, std::function<bool(void)> test_function) : test_function(test_function) {
+    const char* separator = strrchr(file, '/');
+    snprintf(this->name, sizeof(this->name), "%s:%d", separator == nullptr ? file : separator + 1, line);
     if (UnitTest::first == nullptr){
         UnitTest::first = this;
     }
@@ -16,10 +92,115 @@ Tester::Tester(std::function<bool(void)> test_function) : test_function(test_fun
     UnitTest::last = this;
 }
 
-void UnitTest::run(bool abort_at_error, std::function<void(char)> write_function){
+Bencher::Bencher(const char* name, std::function<void(State&)> bench_function) : name(name), bench_function(bench_function) {
+    if (UnitTest::first_bencher == nullptr){
+        UnitTest::first_bencher = this;
+    }
+    if (UnitTest::last_bencher != nullptr){
+        UnitTest::last_bencher->next = this;
+    }
+    UnitTest::last_bencher = this;
+}
+
+Bencher::State::~State(void){
+    this->stop();
+}
+
+void Bencher::State::setAmountOfSamples(size_t amount){
+    this->amount_of_samples_wanted = amount == 0 ? 1 : (amount < State::amount_of_samples ? amount : State::amount_of_samples);
+}
+
+void Bencher::State::pauseTiming(void){
+    this->pause_begin_ticks = System::Trace::now();
+    this->pause_begin = UnitTest::now();
+}
+
+void Bencher::State::resumeTiming(void){
+    this->batch_begin += UnitTest::now() - this->pause_begin;
+    this->batch_begin_ticks += System::Trace::now() - this->pause_begin_ticks;
+}
+
+void Bencher::State::spawn(size_t core, std::function<void(void)> function, std::function<void(void)> wake){
+    if (wake){
+        this->wakes.push_back(wake);
+    }
+    this->threads.emplace_back([core, function](){
+        UnitTest::pin(core);
+        function();
+    });
+}
+
+void Bencher::State::addLatency(uint64_t latency){
+    if (this->latencies.empty()){
+        this->latencies.resize(State::max_latencies);
+    }
+    this->latencies[this->amount_of_latencies % State::max_latencies] = latency;
+    this->amount_of_latencies++;
+}
+
+void Bencher::State::setCounter(const char* name, double value){
+    for (size_t index = 0 ; index < this->amount_of_counters ; index++){
+        if (strcmp(this->counter_names[index], name) == 0){
+            this->counter_values[index] = value;
+            return;
+        }
+    }
+    if (this->amount_of_counters < State::max_counters){
+        this->counter_names[this->amount_of_counters] = name;
+        this->counter_values[this->amount_of_counters] = value;
+        this->amount_of_counters++;
+    }
+}
+
+/*
+ * Stop the spawned threads: they see isRunning() turn false, the blocked ones are woken.
+ */
+void Bencher::State::stop(void){
+    this->running.store(false, std::memory_order_relaxed);
+    for (auto& wake : this->wakes){
+        wake();
+    }
+    for (auto& thread : this->threads){
+        thread.join();
+    }
+    this->threads.clear();
+    this->wakes.clear();
+}
+
+bool Bencher::State::nextBatch(void){
+    uint64_t time = UnitTest::now();
+    uint64_t ticks = System::Trace::now();
+    if (this->started){
+        uint64_t elapsed = time - this->batch_begin;
+        if (this->calibrated == false){
+            if (elapsed < State::batch_time && this->batch_size < (1ull << 40)){
+                this->batch_size <<= 1;
+            } else {
+                this->calibrated = true;
+            }
+        }
+        if (this->calibrated){
+            this->samples[this->amount_of_samples_taken] = static_cast<double>(elapsed) / this->batch_size;
+            this->tick_samples[this->amount_of_samples_taken] = static_cast<double>(ticks - this->batch_begin_ticks) / this->batch_size;
+            this->iterations += this->batch_size;
+            this->amount_of_samples_taken++;
+            if (this->amount_of_samples_taken == this->amount_of_samples_wanted){
+                this->stop();
+                return false;
+            }
+        }
+    }
+    this->started = true;
+    this->remaining = this->batch_size - 1;
+    this->batch_begin_ticks = System::Trace::now();
+    this->batch_begin = UnitTest::now();
+    return true;
+}
+
+void UnitTest::run(bool abort_at_error, System::Sink* sink){
     uint16_t error_counter = 0;
     uint16_t error_totalizer = 0;
-    UnitTest::write_function = write_function;
+    UnitTest::sink = sink;
     UnitTest::log("[!] Running tests...\r\n\r\n");
     for (Tester* iterator = UnitTest::first ; iterator != nullptr ; iterator = iterator->next){
         if (iterator->test_function() == false){
@@ -45,12 +226,335 @@ void UnitTest::run(bool abort_at_error, std::function<void(char)> write_function
 }
 
 void UnitTest::log(const char* message, ...){
-    char buffer[100] = {0};
+    char buffer[256];
+    std::string text;
+    const char* formatted = nullptr;
     va_list arguments;
     va_start(arguments, message);
-    vsnprintf(buffer, 100, message, arguments);
-    for(const auto& byte : buffer){
-        UnitTest::write_function(byte);
+    size_t length = format(buffer, sizeof(buffer), text, formatted, message, arguments);
+    va_end(arguments);
+    if (length != 0){
+        UnitTest::write(formatted, length);
     }
+}
+
+void UnitTest::logLine(int line, const char* message, ...){
+    char prefix[32];
+    int prefix_length = snprintf(prefix, sizeof(prefix), "[%d] User log: ", line);
+    char buffer[256];
+    std::string text;
+    const char* formatted = nullptr;
+    va_list arguments;
+    va_start(arguments, message);
+    size_t length = format(buffer, sizeof(buffer), text, formatted, message, arguments);
     va_end(arguments);
+    struct iovec fragments[3] = {
+        {prefix, static_cast<size_t>(prefix_length)},
+        {const_cast<char*>(formatted), length},
+        {const_cast<char*>("\r\n"), 2},
+    };
+    UnitTest::write(fragments, 3);
+}
+
+bool UnitTest::check(int line, const char* description, bool passed){
+    char prefix[16];
+    int prefix_length = snprintf(prefix, sizeof(prefix), "%d: ", line);
+    struct iovec fragments[3] = {
+        {prefix, static_cast<size_t>(prefix_length)},
+        {const_cast<char*>(description), strlen(description)},
+        {const_cast<char*>(passed ? "Ok!\r\n" : "Error!\r\n"), passed ? 5u : 8u},
+    };
+    UnitTest::write(fragments, 3);
+    return passed;
+}
+
+void UnitTest::write(const char* data, size_t size){
+    struct iovec fragment = {const_cast<char*>(data), size};
+    UnitTest::write(&fragment, 1);
+}
+
+void UnitTest::write(const struct iovec* fragments, size_t amount_of_fragments){
+    if (UnitTest::sink != nullptr){
+        UnitTest::sink->write(fragments, amount_of_fragments);
+    } else {
+        System::IOStream::write(fragments, amount_of_fragments);
+    }
+}
+
+uint64_t UnitTest::now(void){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void UnitTest::pin(size_t core){
+    unsigned amount_of_cores = std::thread::hardware_concurrency();
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core % (amount_of_cores == 0 ? 1 : amount_of_cores), &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+}
+
+size_t UnitTest::bench(const char* filter, System::Sink* json, const char* baseline_path, double tolerance){
+    std::string baseline;
+    if (baseline_path != nullptr){
+        FILE* file = fopen(baseline_path, "rb");
+        if (file == nullptr){
+            UnitTest::log("[x] Could not open the baseline %s.\r\n", baseline_path);
+        } else {
+            char buffer[4096];
+            size_t size = 0;
+            while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0){
+                baseline.append(buffer, size);
+            }
+            fclose(file);
+        }
+    }
+
+    UnitTest::log("[!] Running benchmarks on %u core(s), check policy %s, SYSTEM_TRACE=%d...\r\n\r\n", std::thread::hardware_concurrency(), checkPolicyName(), SYSTEM_TRACE);
+    if (json != nullptr){
+        json->write("{\"benchmarks\":[\n", 16);
+    }
+    size_t amount_of_benchmarks = 0;
+    size_t regressions = 0;
+    for (Bencher* iterator = UnitTest::first_bencher ; iterator != nullptr ; iterator = iterator->next){
+        if (filter != nullptr && strstr(iterator->name, filter) == nullptr){
+            continue;
+        }
+        Bencher::State state;
+        iterator->bench_function(state);
+        size_t amount_of_samples = state.amount_of_samples_taken;
+        if (amount_of_samples == 0){
+            UnitTest::log("    %-64s [x] UNIT_BENCH_MEASURE was not reached\r\n", iterator->name);
+            continue;
+        }
+        std::sort(state.samples, state.samples + amount_of_samples);
+        std::sort(state.tick_samples, state.tick_samples + amount_of_samples);
+        double median = state.samples[amount_of_samples / 2];
+        double p99 = state.samples[(amount_of_samples * 99) / 100];
+        double ticks = state.tick_samples[amount_of_samples / 2];
+        double operations_per_second = median > 0 ? 1e9 / median : 0;
+
+        UnitTest::log("    %-64s %10.2f ns  p99 %10.2f ns  %14.0f ops/s", iterator->name, median, p99, operations_per_second);
+        double baseline_median = baseline.empty() ? 0 : baselineMedian(baseline, iterator->name);
+        if (baseline_median > 0){
+            double change = (median - baseline_median) / baseline_median;
+            UnitTest::log("  %+7.1f%%", change * 100);
+            if (change > tolerance){
+                UnitTest::log("  [x] regression");
+                regressions++;
+            }
+        }
+        UnitTest::log("\r\n");
+
+        /*
+         * The latencies added by a producer/consumer setup and the counters go on their own lines.
+         */
+        size_t amount_of_latencies = state.amount_of_latencies < Bencher::State::max_latencies ? state.amount_of_latencies : Bencher::State::max_latencies;
+        uint64_t latency_median = 0;
+        uint64_t latency_p99 = 0;
+        if (amount_of_latencies != 0){
+            std::sort(state.latencies.begin(), state.latencies.begin() + amount_of_latencies);
+            latency_median = state.latencies[amount_of_latencies / 2];
+            latency_p99 = state.latencies[(amount_of_latencies * 99) / 100];
+            UnitTest::log("        latency %10llu ns  p99 %10llu ns\r\n", static_cast<unsigned long long>(latency_median), static_cast<unsigned long long>(latency_p99));
+        }
+        for (size_t index = 0 ; index < state.amount_of_counters ; index++){
+            UnitTest::log("        %s %.10g\r\n", state.counter_names[index], state.counter_values[index]);
+        }
+
+        if (json != nullptr){
+            char line[256];
+            int length = snprintf(line, sizeof(line),
+                "%s{\"name\":\"%s\",\"iterations\":%llu,\"median_ns\":%.3f,\"p99_ns\":%.3f,\"ops_per_second\":%.0f,\"ticks_per_op\":%.3f",
+                amount_of_benchmarks == 0 ? "" : ",\n", iterator->name, static_cast<unsigned long long>(state.iterations), median, p99, operations_per_second, ticks);
+            std::string text(line, static_cast<size_t>(length) < sizeof(line) ? length : sizeof(line) - 1);
+            if (amount_of_latencies != 0){
+                snprintf(line, sizeof(line), ",\"latency_median_ns\":%llu,\"latency_p99_ns\":%llu", static_cast<unsigned long long>(latency_median), static_cast<unsigned long long>(latency_p99));
+                text += line;
+            }
+            for (size_t index = 0 ; index < state.amount_of_counters ; index++){
+                snprintf(line, sizeof(line), "%s\"%s\":%.3f", index == 0 ? ",\"counters\":{" : ",", state.counter_names[index], state.counter_values[index]);
+                text += line;
+            }
+            text += state.amount_of_counters == 0 ? "}" : "}}";
+            json->write(text.data(), text.size());
+        }
+        amount_of_benchmarks++;
+    }
+    if (json != nullptr){
+        json->write("\n]}\n", 4);
+        json->flush();
+    }
+    if (regressions == 0){
+        UnitTest::log("\r\n[v] %zu benchmark(s) run.\r\n", amount_of_benchmarks);
+    } else {
+        UnitTest::log("\r\n[x] %zu benchmark(s) run, %zu regression(s) above %.0f%%.\r\n", amount_of_benchmarks, regressions, tolerance * 100);
+    }
+    return regressions;
+}
+
+size_t UnitTest::runIsolated(size_t amount_of_workers, uint32_t timeout, const char* filter, System::Sink* sink){
+    UnitTest::sink = sink;
+    if (amount_of_workers == 0){
+        long amount_of_cores = sysconf(_SC_NPROCESSORS_ONLN);
+        amount_of_workers = amount_of_cores > 0 ? amount_of_cores : 1;
+    }
+    UnitTest::log("[!] Running tests in %zu worker(s)...\r\n\r\n", amount_of_workers);
+
+    std::vector<Worker> workers(amount_of_workers);
+    std::vector<struct pollfd> descriptors;
+    Tester* iterator = UnitTest::first;
+    size_t amount_of_tests = 0;
+    size_t amount_of_failures = 0;
+    size_t amount_of_running = 0;
+    uint64_t begin = UnitTest::now();
+    uint64_t total_time = 0;
+    while (iterator != nullptr || amount_of_running != 0){
+
+        /*
+         * Start the next tests on the idle workers. Both standard outputs of the child go to
+         * its pipe, so a crash message is kept with the log of its test.
+         */
+        for (Worker& worker : workers){
+            while (worker.tester == nullptr && iterator != nullptr){
+                Tester* tester = iterator;
+                iterator = iterator->next;
+                if (filter != nullptr && strstr(tester->name, filter) == nullptr){
+                    continue;
+                }
+                int pipe_descriptors[2];
+                if (pipe(pipe_descriptors) != 0){
+                    UnitTest::log("[x] %s could not be started: %s\r\n", tester->name, strerror(errno));
+                    amount_of_tests++;
+                    amount_of_failures++;
+                    continue;
+                }
+                System::IOStream::flush();
+                fflush(nullptr);
+                pid_t process = fork();
+                if (process == 0){
+                    setpgid(0, 0);
+                    close(pipe_descriptors[0]);
+                    dup2(pipe_descriptors[1], STDOUT_FILENO);
+                    dup2(pipe_descriptors[1], STDERR_FILENO);
+                    close(pipe_descriptors[1]);
+                    setvbuf(stdout, nullptr, _IOLBF, BUFSIZ);
+                    UnitTest::sink = nullptr;
+                    bool passed = tester->test_function();
+                    System::IOStream::flush();
+                    fflush(nullptr);
+                    _exit(passed ? 0 : 1);
+                }
+                close(pipe_descriptors[1]);
+                if (process > 0){
+                    setpgid(process, process);
+                }
+                if (process < 0){
+                    close(pipe_descriptors[0]);
+                    UnitTest::log("[x] %s could not be started: %s\r\n", tester->name, strerror(errno));
+                    amount_of_tests++;
+                    amount_of_failures++;
+                    continue;
+                }
+                worker.tester = tester;
+                worker.process = process;
+                worker.descriptor = pipe_descriptors[0];
+                worker.begin = UnitTest::now();
+                worker.timed_out = false;
+                worker.output.clear();
+                amount_of_running++;
+            }
+        }
+
+        /*
+         * Collect the output until the test process exits, killing the late ones with every
+         * process they started. Its pipe is not waited for: a leftover process may hold it open.
+         */
+        descriptors.clear();
+        for (Worker& worker : workers){
+            if (worker.descriptor >= 0){
+                descriptors.push_back({worker.descriptor, POLLIN, 0});
+            }
+        }
+        if (descriptors.empty() == false){
+            poll(descriptors.data(), descriptors.size(), 10);
+        } else {
+            usleep(1000);
+        }
+        for (Worker& worker : workers){
+            if (worker.tester == nullptr){
+                continue;
+            }
+            if (worker.descriptor >= 0){
+                for (const struct pollfd& descriptor : descriptors){
+                    if (descriptor.fd != worker.descriptor || descriptor.revents == 0){
+                        continue;
+                    }
+                    char buffer[4096];
+                    ssize_t size = read(worker.descriptor, buffer, sizeof(buffer));
+                    if (size > 0){
+                        worker.output.append(buffer, size);
+                    } else if (size == 0 || errno != EINTR){
+                        close(worker.descriptor);
+                        worker.descriptor = -1;
+                    }
+                }
+            }
+            uint64_t elapsed = UnitTest::now() - worker.begin;
+            if (timeout != 0 && worker.timed_out == false && elapsed > static_cast<uint64_t>(timeout) * 1000000){
+                kill(-worker.process, SIGKILL);
+                worker.timed_out = true;
+            }
+            /*
+             * Kill what is left of its group before reaping it, while its id can not be reused.
+             */
+            siginfo_t information = {};
+            if (waitid(P_PID, worker.process, &information, WEXITED | WNOHANG | WNOWAIT) != 0 || information.si_pid != worker.process){
+                continue;
+            }
+            kill(-worker.process, SIGKILL);
+            int status = 0;
+            waitpid(worker.process, &status, 0);
+            if (worker.descriptor >= 0){
+                struct pollfd descriptor = {worker.descriptor, POLLIN, 0};
+                char buffer[4096];
+                ssize_t size = 0;
+                while (poll(&descriptor, 1, 0) > 0 && (size = read(worker.descriptor, buffer, sizeof(buffer))) > 0){
+                    worker.output.append(buffer, size);
+                }
+                close(worker.descriptor);
+                worker.descriptor = -1;
+            }
+
+            /*
+             * The test finished: print its log in one piece, then its verdict.
+             */
+            UnitTest::write(worker.output.data(), worker.output.size());
+            double milliseconds = elapsed / 1e6;
+            bool passed = false;
+            if (worker.timed_out){
+                UnitTest::log("[x] %s timed out after %u ms.\r\n", worker.tester->name, timeout);
+            } else if (WIFSIGNALED(status)){
+                UnitTest::log("[x] %s was killed by signal %d (%s) after %.2f ms.\r\n", worker.tester->name, WTERMSIG(status), strsignal(WTERMSIG(status)), milliseconds);
+            } else if (WEXITSTATUS(status) != 0){
+                UnitTest::log("[x] %s failed with exit code %d after %.2f ms.\r\n", worker.tester->name, WEXITSTATUS(status), milliseconds);
+            } else {
+                UnitTest::log("[v] %s passed in %.2f ms.\r\n", worker.tester->name, milliseconds);
+                passed = true;
+            }
+            UnitTest::log("\r\n");
+            amount_of_tests++;
+            amount_of_failures += passed ? 0 : 1;
+            total_time += elapsed;
+            worker.tester = nullptr;
+            amount_of_running--;
+        }
+    }
+
+    double wall_time = (UnitTest::now() - begin) / 1e6;
+    if (amount_of_failures == 0){
+        UnitTest::log("[v] All %zu tests passed in %.2f ms (%.2f ms of test time).\r\n", amount_of_tests, wall_time, total_time / 1e6);
+    } else {
+        UnitTest::log("[x] %zu of %zu tests failed in %.2f ms (%.2f ms of test time).\r\n", amount_of_failures, amount_of_tests, wall_time, total_time / 1e6);
+    }
+    return amount_of_failures;
 }
@@ -1,40 +1,242 @@
 #pragma once
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <atomic>
 #include <functional>
+#include <thread>
+#include <vector>
+#include "../WizardRTOZ/System/IOStream.h"
 
 #define _UNIT_TEST_CONCAT_INNER(a, b) a ## b
 #define _UNIT_TEST_CONCAT(a, b) _UNIT_TEST_CONCAT_INNER(a, b)
 #define _UNIT_TEST_FUNCTION _UNIT_TEST_CONCAT(test_, __LINE__)
+#define _UNIT_BENCH_FUNCTION _UNIT_TEST_CONCAT(bench_, __LINE__)
 
-#define UNIT_TEST_BEGIN static Tester _UNIT_TEST_FUNCTION([](){ UnitTest::log("[%s:%d]\r\n", __FILE__, __LINE__);
+#define UNIT_TEST_BEGIN static Tester _UNIT_TEST_FUNCTION(__FILE__, __LINE__, [](){ UnitTest::log("[%s:%d]\r\n", __FILE__, __LINE__);
 #define UNIT_TEST_END UnitTest::log("[v] Test completed successfully!\r\n"); return true; });
-#define UNIT_TEST_LOG(...) UnitTest::log("[%d] User log: ", __LINE__); UnitTest::log(__VA_ARGS__); UnitTest::log("\r\n")
-#define UNIT_TEST_ASSERT(expression) UnitTest::log("%d: Checking expression '" #expression "'... ", __LINE__); if((expression) == false) { UnitTest::log("Error!\r\n"); return false; } UnitTest::log("Ok!\r\n")
-#define UNIT_TEST_COMPARE(value1, value2) UnitTest::log("%d: Checking if values '" #value1 "' and '" #value2 "' are equals... " , __LINE__); if((value1) != (value2)) { UnitTest::log("Error!\r\n"); return false; } UnitTest::log("Ok!\r\n")
+#define UNIT_TEST_LOG(...) UnitTest::logLine(__LINE__, __VA_ARGS__)
+#define UNIT_TEST_ASSERT(expression) if (UnitTest::check(__LINE__, "Checking expression '" #expression "'... ", (expression)) == false) { return false; }
+#define UNIT_TEST_COMPARE(value1, value2) if (UnitTest::check(__LINE__, "Checking if values '" #value1 "' and '" #value2 "' are equals... ", ((value1) != (value2)) == false) == false) { return false; }
+
+/*
+ * A benchmark body sets up its data, then repeats the measured statement in UNIT_BENCH_MEASURE.
+ * Keep results alive with UnitTest::doNotOptimize so the compiler cannot drop the work.
+ * UNIT_BENCH_STATE is the Bencher::State of the body, for helpers and the threads it spawns.
+ */
+#define UNIT_BENCH_BEGIN(name) static Bencher _UNIT_BENCH_FUNCTION(name, [](Bencher::State& _unit_bench_state){
+#define UNIT_BENCH_END });
+#define UNIT_BENCH_STATE _unit_bench_state
+#define UNIT_BENCH_MEASURE while (_unit_bench_state.keepRunning())
 
 #define USING_UNIT_TEST public: static bool unitTest(void); private:
 #define UNIT_TEST_CLASS_BEGIN(class_name) bool class_name::unitTest(void){
 #define UNIT_TEST_CLASS_END return true;} UNIT_TEST_BEGIN{return AnyClass::unitTest();}UNIT_TEST_END
 
 class Tester;
+class Bencher;
 
 class UnitTest{
     friend class Tester;
+    friend class Bencher;
 private:
     static Tester* first;
     static Tester* last;
-    static std::function<void(char)> write_function;
+    static Bencher* first_bencher;
+    static Bencher* last_bencher;
+    static System::Sink* sink;
+    static void write(const char* data, size_t size);
+    static void write(const struct iovec* fragments, size_t amount_of_fragments);
 public:
-    static void run(bool abort_at_error = true, std::function<void(char)> write_function = [](char data){fputc(data, stdout);});
+    /**
+     * @brief Run every registered test.
+     *
+     * @param abort_at_error Stop at the first failed test.
+     * @param sink Destination of the log, or nullptr to log through System::IOStream.
+     */
+    static void run(bool abort_at_error = true, System::Sink* sink = nullptr);
     static void log(const char* message, ...) __attribute__((format(printf, 1, 2)));
+
+    /**
+     * @brief Log "[line] User log: message" as one write.
+     */
+    static void logLine(int line, const char* message, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * @brief Log "line: description" and the verdict of a check as one gathered write.
+     *
+     * @return passed.
+     */
+    static bool check(int line, const char* description, bool passed);
+
+    /**
+     * @brief Run every registered test in its own process, amount_of_workers at a time.
+     *
+     * A crash, an exit (as System::Exception does on errors) or a hang only fails its own test.
+     * The log of each test is printed in one piece when it ends, followed by its verdict and time.
+     * Asynchronous IOStream sinks must be detached first: their drain thread is not forked.
+     *
+     * @param amount_of_workers Tests run at the same time, or 0 for one per core.
+     * @param timeout Milliseconds a test may run before it is killed, or 0 for no limit.
+     * @param filter Substring of the test names ("file.cpp:line") to run, or nullptr to run all of them.
+     * @param sink Destination of the log, or nullptr to log through System::IOStream.
+     *
+     * @return The amount of failed tests.
+     */
+    static size_t runIsolated(size_t amount_of_workers = 0, uint32_t timeout = 10000, const char* filter = nullptr, System::Sink* sink = nullptr);
+
+    /**
+     * @brief Run every registered benchmark whose name contains filter.
+     *
+     * @param filter Substring of the benchmark names to run, or nullptr to run all of them.
+     * @param json Receives the results as JSON, one benchmark per line, or nullptr.
+     * @param baseline_path JSON written by a previous run to compare the medians with, or nullptr.
+     * @param tolerance Relative slowdown of the median reported as a regression.
+     *
+     * @return The amount of regressions against the baseline.
+     */
+    static size_t bench(const char* filter = nullptr, System::Sink* json = nullptr, const char* baseline_path = nullptr, double tolerance = 0.10);
+
+    /**
+     * @brief Monotonic timestamp in nanoseconds, comparable between cores.
+     */
+    static uint64_t now(void);
+
+    /**
+     * @brief Pin the calling thread to a core (wrapped around the amount of cores available).
+     */
+    static void pin(size_t core);
+
+    /**
+     * @brief Make the compiler assume value is used, so its computation is kept.
+     */
+    template <typename DATA_TYPE> static inline void doNotOptimize(DATA_TYPE const& value){
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief Make the compiler assume every memory write so far is read.
+     */
+    static inline void clobberMemory(void){
+        asm volatile("" : : : "memory");
+    }
 };
 
 class Tester{
     friend class UnitTest;
 private:
     Tester* next {nullptr};
+    char name[64] {};       ///< "file.cpp:line"
     const std::function<bool(void)> test_function;
 public:
-    Tester(std::function<bool(void)> test_function);
+    Tester(const char* file, int line, std::function<bool(void)> test_function);
+};
+
+class Bencher{
+    friend class UnitTest;
+public:
+    /**
+     * @class State
+     *
+     * @brief Runs the measured statement in batches and keeps the time per iteration of each batch.
+     *
+     * The batch size doubles until a batch takes at least batch_time, then amount_of_samples
+     * batches of that size are timed.
+     *
+     * The measured statement may be one end of a producer/consumer setup: spawn() runs the other
+     * end on its own threads for as long as the measurement, and addLatency() keeps the latency
+     * of the messages they receive.
+     */
+    class State{
+        friend class UnitTest;
+    public:
+        static constexpr size_t amount_of_samples = 101;
+        static constexpr uint64_t batch_time = 200000;     ///< Nanoseconds
+        static constexpr size_t max_latencies = 1 << 16;    ///< Latencies kept, the last ones added
+        static constexpr size_t max_counters = 4;
+    private:
+        uint64_t batch_size {1};
+        uint64_t remaining {0};
+        uint64_t batch_begin {0};
+        uint64_t batch_begin_ticks {0};
+        uint64_t pause_begin {0};
+        uint64_t pause_begin_ticks {0};
+        uint64_t iterations {0};
+        bool started {false};
+        bool calibrated {false};
+        size_t amount_of_samples_wanted {State::amount_of_samples};
+        size_t amount_of_samples_taken {0};
+        double samples[State::amount_of_samples] {};           ///< Nanoseconds per iteration
+        double tick_samples[State::amount_of_samples] {};      ///< Ticks per iteration
+        std::atomic<bool> running {true};
+        std::vector<std::thread> threads;
+        std::vector<std::function<void(void)>> wakes;
+        std::vector<uint64_t> latencies;
+        size_t amount_of_latencies {0};
+        const char* counter_names[State::max_counters] {};
+        double counter_values[State::max_counters] {};
+        size_t amount_of_counters {0};
+        bool nextBatch(void);
+        void stop(void);
+    public:
+        State(void) = default;
+        State(const State&) = delete;
+        State& operator=(const State&) = delete;
+        ~State(void);
+
+        inline bool keepRunning(void){
+            if (this->remaining != 0) [[likely]] {
+                this->remaining--;
+                return true;
+            }
+            return this->nextBatch();
+        }
+
+        /**
+         * @brief Time amount batches instead of amount_of_samples, for statements taking milliseconds.
+         */
+        void setAmountOfSamples(size_t amount);
+
+        /**
+         * @brief Leave the time until resumeTiming() out of the batch, such as the setup of a
+         * statement taking milliseconds.
+         */
+        void pauseTiming(void);
+        void resumeTiming(void);
+
+        /**
+         * @brief Run function on its own thread, pinned to core, until the measurement ends.
+         *
+         * function returns once isRunning() is false. The threads are joined when the last batch
+         * ends, before the body goes on after UNIT_BENCH_MEASURE.
+         *
+         * @param core The core of the thread, as UnitTest::pin.
+         * @param function The other end of the measured statement.
+         * @param wake Called once isRunning() is false, to release function when it may be blocked.
+         */
+        void spawn(size_t core, std::function<void(void)> function, std::function<void(void)> wake = nullptr);
+        inline bool isRunning(void) const {
+            return this->running.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Keep the latency of one message to report its percentiles. From one thread at a time.
+         *
+         * @param latency Nanoseconds, usually UnitTest::now() minus the time stamp of the message.
+         */
+        void addLatency(uint64_t latency);
+
+        /**
+         * @brief Report value next to the results, such as the bytes written or dropped.
+         *
+         * @param name A string literal.
+         */
+        void setCounter(const char* name, double value);
+    };
+private:
+    Bencher* next {nullptr};
+    const char* name;
+    const std::function<void(State&)> bench_function;
+public:
+    Bencher(const char* name, std::function<void(State&)> bench_function);
 };
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "./SPSCQueue.h"
+#include "./MPSCQueue.h"
+#include "./MessageBus.h"
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <utility>
+
+#include "./SPSCQueue.h"
+
+namespace Communication{
+
+    /**
+     * @class MPSCQueue
+     *
+     * @brief Unbounded intrusive lock-free queue for many producers and one consumer.
+     *
+     * The queue never allocates: callers own the Element storage (typically a slot of a
+     * MemoryManager::MemoryPool) and the element carries the payload handle by value.
+     * An element must not be pushed again before the consumer has popped it.
+     *
+     * @tparam DATA_TYPE The payload type carried by each element.
+     */
+    template <typename DATA_TYPE>
+    class MPSCQueue{
+    private:
+        class Link{
+            friend class MPSCQueue;
+        private:
+            std::atomic<Link*> next {nullptr};
+        };
+    public:
+        class Element : private Link{
+            friend class MPSCQueue;
+        private:
+            DATA_TYPE data;
+        public:
+            inline Element(void) : data() {}
+            inline Element(DATA_TYPE&& data) : data(std::move(data)) {}
+            inline DATA_TYPE& getData(void){
+                return this->data;
+            }
+            inline void setData(DATA_TYPE&& data){
+                this->data = std::move(data);
+            }
+            inline operator DATA_TYPE&(){
+                return this->data;
+            }
+        };
+    private:
+        alignas(cache_line_size) std::atomic<Link*> head;   ///< Last linked element, shared by the producers
+        alignas(cache_line_size) Link* tail;                ///< Next element to be read, owned by the consumer
+        Link stub;
+
+        inline void link(Link* link){
+            link->next.store(nullptr, std::memory_order_relaxed);
+            Link* previous = this->head.exchange(link, std::memory_order_acq_rel);
+            previous->next.store(link, std::memory_order_release);
+        }
+    public:
+        inline MPSCQueue(void) : head(&this->stub), tail(&this->stub) {}
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        /**
+         * @brief Link an element at the end of the queue. Safe from any thread.
+         *
+         * @param element The element to queue.
+         */
+        inline void push(Element& element){
+            this->link(&element);
+        }
+
+        /**
+         * @brief Unlink the oldest element (consumer side).
+         *
+         * @return The element, or nullptr when the queue is empty or a producer is halfway through a push.
+         */
+        inline Element* pop(void){
+            Link* tail = this->tail;
+            Link* next = tail->next.load(std::memory_order_acquire);
+            if (tail == &this->stub){
+                if (next == nullptr){
+                    return nullptr;
+                }
+                this->tail = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+            if (next != nullptr){
+                this->tail = next;
+                return static_cast<Element*>(tail);
+            }
+            if (tail != this->head.load(std::memory_order_acquire)){
+                return nullptr;
+            }
+            this->link(&this->stub);
+            next = tail->next.load(std::memory_order_acquire);
+            if (next != nullptr){
+                this->tail = next;
+                return static_cast<Element*>(tail);
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Unlink up to amount_of_elements elements (consumer side).
+         *
+         * @param elements Destination of the element pointers.
+         * @param amount_of_elements The room available in elements.
+         *
+         * @return The amount of elements read.
+         */
+        inline size_t pop(Element** elements, size_t amount_of_elements){
+            size_t amount_read = 0;
+            while (amount_read < amount_of_elements && (elements[amount_read] = this->pop()) != nullptr){
+                amount_read++;
+            }
+            return amount_read;
+        }
+
+        inline bool isEmpty(void) const {
+            return this->tail == &this->stub && this->stub.next.load(std::memory_order_acquire) == nullptr;
+        }
+    };
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <utility>
+
+#include "../System/Exception.h"
+#include "../MemoryManager/MemoryPool.h"
+#include "../MemoryManager/StaticList.h"
+#include "../Synchronization/Mutex.h"
+#include "../Synchronization/Semaphore.h"
+#include "../Synchronization/SpinLock.h"
+#include "./SPSCQueue.h"
+
+namespace Communication{
+
+    /**
+     * @enum DropPolicy
+     *
+     * @brief What a topic does when a subscriber queue is full.
+     */
+    enum class DropPolicy : uint8_t {
+        drop_newest,    ///< Discard the message being published for that subscriber
+        drop_oldest,    ///< Discard the oldest message queued for that subscriber
+        block,          ///< Wait until the subscriber makes room
+    };
+
+    /**
+     * @class MessageBus
+     *
+     * @brief Topic based publish/subscribe bus that fans messages out without copying them.
+     *
+     * Messages are reference counted blocks of a MemoryManager::MemoryPool. Every subscriber
+     * receives a shared handle to the same block, which goes back to the pool when the last
+     * handle is released.
+     *
+     * @tparam MESSAGE_TYPE The message type. It must be default constructible.
+     * @tparam POOL_SIZE The amount of messages alive at the same time.
+     * @tparam QUEUE_CAPACITY Maximum depth of a subscriber queue. It must be a power of two.
+     */
+    template <typename MESSAGE_TYPE, size_t POOL_SIZE, size_t QUEUE_CAPACITY = 16>
+    class MessageBus{
+    private:
+        struct Block{
+            std::atomic<uint32_t> references {0};
+            MESSAGE_TYPE data {};
+        };
+        using Pool = MemoryManager::MemoryPool<Block, POOL_SIZE>;
+
+        Pool pool;
+        typename Pool::Reference allocations[POOL_SIZE];    ///< Owner of each allocated block, by block index
+        Synchronization::SpinLock pool_lock;
+
+        inline void recycle(Block* block){
+            this->pool_lock.lock();
+            this->allocations[block - this->pool.begin()].release();
+            this->pool_lock.unlock();
+        }
+    public:
+        class Topic;
+        class Subscriber;
+
+        /**
+         * @class Message
+         *
+         * @brief Shared handle to a pooled message. Copies share the block, they never copy it.
+         */
+        class Message{
+            friend class MessageBus;
+        private:
+            MessageBus* bus {nullptr};
+            Block* block {nullptr};
+            inline Message(MessageBus* bus, Block* block) : bus(bus), block(block) {}
+        public:
+            inline Message(void) {}
+            inline Message(const Message& message) : bus(message.bus), block(message.block) {
+                if (this->block != nullptr){
+                    this->block->references.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            inline Message(Message&& message) : bus(message.bus), block(message.block) {
+                message.block = nullptr;
+            }
+            inline ~Message(void){
+                this->release();
+            }
+            inline Message& operator=(const Message& message){
+                if (this != &message){
+                    Message copy(message);
+                    *this = std::move(copy);
+                }
+                return *this;
+            }
+            inline Message& operator=(Message&& message){
+                if (this != &message){
+                    this->release();
+                    this->bus = message.bus;
+                    this->block = message.block;
+                    message.block = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Drop this handle, returning the block to the pool if it was the last one.
+             */
+            inline void release(void){
+                if (this->block != nullptr && this->block->references.fetch_sub(1, std::memory_order_acq_rel) == 1){
+                    this->bus->recycle(this->block);
+                }
+                this->block = nullptr;
+            }
+            inline bool isEmpty(void) const {
+                return (this->block == nullptr);
+            }
+            inline uint32_t getReferences(void) const {
+                return this->block == nullptr ? 0 : this->block->references.load(std::memory_order_relaxed);
+            }
+            inline MESSAGE_TYPE& getData(void) const {
+                return this->block->data;
+            }
+            inline MESSAGE_TYPE& operator*(void) const {
+                return this->block->data;
+            }
+            inline MESSAGE_TYPE* operator->(void) const {
+                return &this->block->data;
+            }
+        };
+
+        /**
+         * @class Subscriber
+         *
+         * @brief Queue of messages received from one topic, consumed by a single thread.
+         *
+         * The subscriber joins the topic on construction and leaves it on destruction.
+         * Subscribers of a topic are served in StaticList priority order.
+         */
+        class Subscriber{
+            friend class Topic;
+        private:
+            Topic& topic;
+            typename MemoryManager::StaticList<Subscriber>::Element element;
+            SPSCQueue<Message, QUEUE_CAPACITY> queue;
+            Synchronization::SpinLock consumer_lock;    ///< Serializes consumer pops with drop_oldest evictions
+            Synchronization::Semaphore available {0};
+            Synchronization::Semaphore room;
+            std::atomic<uint64_t> dropped {0};
+
+            inline bool pop(Message& message){
+                this->consumer_lock.lock();
+                bool received = this->queue.pop(message);
+                this->consumer_lock.unlock();
+                if (received && this->topic.policy == DropPolicy::block){
+                    this->room.release();
+                }
+                return received;
+            }
+            inline bool deliver(const Message& message){
+                Message copy(message);
+                if (this->topic.policy == DropPolicy::block){
+                    this->room.acquire();
+                } else if (this->queue.getLenght() >= this->topic.depth){
+                    if (this->topic.policy == DropPolicy::drop_newest){
+                        this->dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    Message oldest;
+                    this->consumer_lock.lock();
+                    if (this->queue.getLenght() >= this->topic.depth && this->queue.pop(oldest)){
+                        this->available.tryAcquire();
+                        this->dropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    this->consumer_lock.unlock();
+                }
+                this->queue.push(copy);
+                this->available.release();
+                return true;
+            }
+        public:
+            inline Subscriber(Topic& topic, uint8_t priority = 0) : topic(topic), element(*this, priority), room(static_cast<int32_t>(topic.depth)) {
+                this->topic.subscribe(*this);
+            }
+            inline ~Subscriber(void){
+                this->topic.unsubscribe(*this);
+            }
+            Subscriber(const Subscriber&) = delete;
+            Subscriber& operator=(const Subscriber&) = delete;
+
+            /**
+             * @brief Take the oldest queued message without waiting.
+             *
+             * @return True when a message was received.
+             */
+            inline bool tryReceive(Message& message){
+                if (this->pop(message) == false){
+                    return false;
+                }
+                this->available.tryAcquire();
+                return true;
+            }
+
+            /**
+             * @brief Wait for the oldest queued message.
+             */
+            inline void receive(Message& message){
+                do {
+                    this->available.acquire();
+                } while (this->pop(message) == false);
+            }
+            inline size_t getLenght(void) const {
+                return this->queue.getLenght();
+            }
+            inline uint64_t getDropped(void) const {
+                return this->dropped.load(std::memory_order_relaxed);
+            }
+        };
+
+        /**
+         * @class Topic
+         *
+         * @brief Set of subscribers sharing a queue depth and a drop policy.
+         */
+        class Topic{
+            friend class Subscriber;
+        private:
+            Synchronization::Mutex mutex;
+            MemoryManager::StaticList<Subscriber> subscribers;
+            const size_t depth;
+            const DropPolicy policy;
+
+            inline void subscribe(Subscriber& subscriber){
+                Synchronization::LockGuard guard(this->mutex);
+                this->subscribers.append(subscriber.element);
+            }
+            inline void unsubscribe(Subscriber& subscriber){
+                Synchronization::LockGuard guard(this->mutex);
+                this->subscribers.remove(subscriber.element);
+            }
+        public:
+            inline Topic(size_t depth = QUEUE_CAPACITY, DropPolicy policy = DropPolicy::drop_newest) : depth(depth), policy(policy) {
+                System::Exceptions::length_error.test(depth == 0 || depth > QUEUE_CAPACITY, "Invalid queue depth.");
+            }
+            Topic(const Topic&) = delete;
+            Topic& operator=(const Topic&) = delete;
+
+            /**
+             * @brief Hand a message to every subscriber. Safe from any thread.
+             *
+             * With DropPolicy::block, a subscriber that does not consume stalls the topic.
+             *
+             * @return The amount of subscribers that queued the message.
+             */
+            inline size_t publish(const Message& message){
+                size_t delivered = 0;
+                Synchronization::LockGuard guard(this->mutex);
+                for (auto* element = this->subscribers.getFirst() ; element != nullptr ; element = element->getNext()){
+                    delivered += element->getData().deliver(message) ? 1 : 0;
+                }
+                return delivered;
+            }
+            inline size_t getSubscribers(void) const {
+                return this->subscribers.getLenght();
+            }
+        };
+
+        inline MessageBus(void) {}
+        MessageBus(const MessageBus&) = delete;
+        MessageBus& operator=(const MessageBus&) = delete;
+
+        /**
+         * @brief Take a block from the pool to be filled and published. Safe from any thread.
+         *
+         * @return The message, empty when the pool is exhausted.
+         */
+        inline Message allocate(void){
+            this->pool_lock.lock();
+            if (this->pool.getFreeSpace() == 0){
+                this->pool_lock.unlock();
+                return Message();
+            }
+            typename Pool::Reference reference = this->pool.allocate();
+            Block* block = reference.begin();
+            this->allocations[block - this->pool.begin()] = std::move(reference);
+            this->pool_lock.unlock();
+            block->references.store(1, std::memory_order_relaxed);
+            return Message(this, block);
+        }
+        inline size_t getFreeSpace(void){
+            return this->pool.getFreeSpace();
+        }
+    };
+}
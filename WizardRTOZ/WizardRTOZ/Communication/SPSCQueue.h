@@ -0,0 +1,120 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <utility>
+
+/**
+ * @namespace Communication
+ *
+ * @brief Namespace containing inter-task communication utilities.
+ */
+namespace Communication{
+
+    static constexpr size_t cache_line_size = 64;   ///< Alignment used to keep producer and consumer indexes apart
+
+    /**
+     * @class SPSCQueue
+     *
+     * @brief Bounded lock-free ring for exactly one producer and one consumer.
+     *
+     * Items are moved in and out of the ring, so a MemoryPool::Reference travels through it
+     * as a handle and the pooled payload is never copied.
+     *
+     * @tparam DATA_TYPE The item type. It must be default constructible and move assignable.
+     * @tparam CAPACITY The amount of slots. It must be a power of two.
+     */
+    template <typename DATA_TYPE, size_t CAPACITY>
+    class SPSCQueue{
+        static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "The capacity must be a power of two.");
+    private:
+        static constexpr size_t mask = CAPACITY - 1;
+
+        alignas(cache_line_size) std::atomic<size_t> head {0};     ///< Next slot to be read, written by the consumer
+        size_t tail_cache {0};                                      ///< Consumer copy of tail
+        alignas(cache_line_size) std::atomic<size_t> tail {0};     ///< Next slot to be written, written by the producer
+        size_t head_cache {0};                                      ///< Producer copy of head
+        alignas(cache_line_size) DATA_TYPE data[CAPACITY] {};
+    public:
+        inline SPSCQueue(void) {}
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        /**
+         * @brief Move an item into the queue (producer side).
+         *
+         * @param item The item to move. It is left untouched when the queue is full.
+         *
+         * @return True when the item was queued.
+         */
+        inline bool push(DATA_TYPE& item){
+            return this->push(&item, 1) == 1;
+        }
+
+        /**
+         * @brief Move up to amount_of_items items into the queue (producer side).
+         *
+         * @param items The items to move.
+         * @param amount_of_items The amount of items available.
+         *
+         * @return The amount of items queued, taken from the front of items.
+         */
+        inline size_t push(DATA_TYPE* items, size_t amount_of_items){
+            const size_t tail = this->tail.load(std::memory_order_relaxed);
+            if ((CAPACITY - (tail - this->head_cache)) < amount_of_items){
+                this->head_cache = this->head.load(std::memory_order_acquire);
+            }
+            const size_t free_slots = CAPACITY - (tail - this->head_cache);
+            amount_of_items = amount_of_items < free_slots ? amount_of_items : free_slots;
+            for (size_t index = 0 ; index < amount_of_items ; index++){
+                this->data[(tail + index) & SPSCQueue::mask] = std::move(items[index]);
+            }
+            this->tail.store(tail + amount_of_items, std::memory_order_release);
+            return amount_of_items;
+        }
+
+        /**
+         * @brief Move the oldest item out of the queue (consumer side).
+         *
+         * @param item Destination of the item.
+         *
+         * @return True when an item was read.
+         */
+        inline bool pop(DATA_TYPE& item){
+            return this->pop(&item, 1) == 1;
+        }
+
+        /**
+         * @brief Move up to amount_of_items items out of the queue (consumer side).
+         *
+         * @param items Destination of the items.
+         * @param amount_of_items The room available in items.
+         *
+         * @return The amount of items read.
+         */
+        inline size_t pop(DATA_TYPE* items, size_t amount_of_items){
+            const size_t head = this->head.load(std::memory_order_relaxed);
+            if ((this->tail_cache - head) < amount_of_items){
+                this->tail_cache = this->tail.load(std::memory_order_acquire);
+            }
+            const size_t used_slots = this->tail_cache - head;
+            amount_of_items = amount_of_items < used_slots ? amount_of_items : used_slots;
+            for (size_t index = 0 ; index < amount_of_items ; index++){
+                items[index] = std::move(this->data[(head + index) & SPSCQueue::mask]);
+            }
+            this->head.store(head + amount_of_items, std::memory_order_release);
+            return amount_of_items;
+        }
+
+        inline size_t getLenght(void) const {
+            return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+        }
+        inline bool isEmpty(void) const {
+            return this->getLenght() == 0;
+        }
+        inline constexpr size_t getCapacity(void) const {
+            return CAPACITY;
+        }
+    };
+}
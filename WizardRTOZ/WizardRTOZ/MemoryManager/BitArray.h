@@ -12,21 +12,37 @@
 namespace MemoryManager{
     template <size_t AMOUNT_OF_BITS = 8>
     class BitArray{
+    public:
+        static constexpr size_t size_in_bytes = (((AMOUNT_OF_BITS) < 8) ? 1 : (((AMOUNT_OF_BITS - 1) >> 3) + 1));
+        static constexpr size_t size_in_bits = AMOUNT_OF_BITS;
     private:
         class Binary{
         public:
             size_t mask {0};
             size_t byte {0};
             uint8_t bit {0};
-            inline Binary(size_t bit_position, uint8_t amount_of_bits){
-                System::Exceptions::out_of_range.test((bit_position + amount_of_bits) > AMOUNT_OF_BITS, "Position argument is not allowed by this object.");
-                System::Exceptions::length_error.test(amount_of_bits == 0, "Invalid amount of bit to write number.");
+            inline Binary(size_t bit_position, uint8_t amount_of_bits, bool checked = true){
+                if (checked){
+                    System::Exceptions::out_of_range.test((bit_position + amount_of_bits) > AMOUNT_OF_BITS, "Position argument is not allowed by this object.");
+                    System::Exceptions::length_error.test(amount_of_bits == 0, "Invalid amount of bit to write number.");
+                }
                 this->bit = (bit_position & 7);
                 this->byte = (bit_position >> 3);
                 this->mask = ((1 << (amount_of_bits)) - 1);
             }
+            static inline System::Status check(size_t bit_position, uint8_t amount_of_bits){
+                System::Status status = System::Exceptions::out_of_range.check((bit_position + amount_of_bits) > AMOUNT_OF_BITS);
+                return (status != System::Status::ok) ? status : System::Exceptions::length_error.check(amount_of_bits == 0);
+            }
         };
         uint8_t data[BitArray<AMOUNT_OF_BITS>::size_in_bytes] {0};
+        inline void write(const Binary& binary, bool value){
+            if (value == true){
+                this->data[binary.byte] |= (binary.mask << binary.bit);
+            } else {
+                this->data[binary.byte] &= ~(binary.mask << binary.bit);
+            }
+        }
     public:
         class Reference{
         private:
@@ -74,9 +90,6 @@ namespace MemoryManager{
                 return !(*this == reference);
             }
         };
-        static constexpr size_t size_in_bytes = (((AMOUNT_OF_BITS) < 8) ? 1 : (((AMOUNT_OF_BITS - 1) >> 3) + 1));
-        static constexpr size_t size_in_bits = AMOUNT_OF_BITS;
-
         inline BitArray(void) {
             memset(this->data, 0, BitArray<AMOUNT_OF_BITS>::size_in_bytes);
         }
@@ -94,11 +107,32 @@ namespace MemoryManager{
         }
         template <typename DATA_TYPE> inline void write(size_t bit_position, DATA_TYPE value, uint8_t amount_of_bits = 1){
             BitArray<AMOUNT_OF_BITS>::Binary binary(bit_position, amount_of_bits);
-            if (static_cast<bool>(value) == true){
-                this->data[binary.byte] |= (binary.mask << binary.bit);
-            } else {
-                this->data[binary.byte] &= ~(binary.mask << binary.bit);
-            }
+            this->write(binary, static_cast<bool>(value));
+        }
+
+        /**
+         * @brief Unchecked get: an invalid position returns its status instead of raising an exception.
+         */
+        template <typename DATA_TYPE = bool> inline System::Status tryGet(size_t bit_position, DATA_TYPE& value, uint8_t amount_of_bits = 1){
+            System::Status status = BitArray<AMOUNT_OF_BITS>::Binary::check(bit_position, amount_of_bits);
+            if (status != System::Status::ok) [[unlikely]] {
+                return status;
+            }
+            BitArray<AMOUNT_OF_BITS>::Binary binary(bit_position, amount_of_bits, false);
+            value = static_cast<DATA_TYPE>((this->data[binary.byte] >> binary.bit) & binary.mask);
+            return System::Status::ok;
+        }
+
+        /**
+         * @brief Unchecked write: an invalid position returns its status instead of raising an exception.
+         */
+        template <typename DATA_TYPE> inline System::Status tryWrite(size_t bit_position, DATA_TYPE value, uint8_t amount_of_bits = 1){
+            System::Status status = BitArray<AMOUNT_OF_BITS>::Binary::check(bit_position, amount_of_bits);
+            if (status != System::Status::ok) [[unlikely]] {
+                return status;
+            }
+            this->write(BitArray<AMOUNT_OF_BITS>::Binary(bit_position, amount_of_bits, false), static_cast<bool>(value));
+            return System::Status::ok;
         }
         inline void set(size_t bit_position, uint8_t amount_of_bits = 1){
             this->write(bit_position, true, amount_of_bits);
@@ -113,6 +147,76 @@ namespace MemoryManager{
         inline void fill(bool value){
             memset(this->data, value ? 0xFF : 0x00, BitArray<AMOUNT_OF_BITS>::size_in_bytes);
         }
+
+        /**
+         * @brief Write value to a range of bits of any length, a byte at a time where possible.
+         */
+        inline void fill(size_t bit_position, size_t amount_of_bits, bool value){
+            if (System::Exceptions::out_of_range.test((bit_position + amount_of_bits) > AMOUNT_OF_BITS, "Position argument is not allowed by this object.") == false){
+                return;
+            }
+            size_t last = bit_position + amount_of_bits;
+            while (bit_position < last && (bit_position & 7) != 0){
+                this->write(BitArray<AMOUNT_OF_BITS>::Binary(bit_position++, 1, false), value);
+            }
+            size_t amount_of_bytes = (last - bit_position) >> 3;
+            memset(&this->data[bit_position >> 3], value ? 0xFF : 0x00, amount_of_bytes);
+            bit_position += amount_of_bytes << 3;
+            while (bit_position < last){
+                this->write(BitArray<AMOUNT_OF_BITS>::Binary(bit_position++, 1, false), value);
+            }
+        }
+
+        /**
+         * @brief Whether any bit of a range of any length is set.
+         */
+        inline bool any(size_t bit_position, size_t amount_of_bits){
+            if (System::Exceptions::out_of_range.test((bit_position + amount_of_bits) > AMOUNT_OF_BITS, "Position argument is not allowed by this object.") == false){
+                return true;
+            }
+            size_t last = bit_position + amount_of_bits;
+            for (; bit_position < last && (bit_position & 7) != 0 ; bit_position++){
+                if ((this->data[bit_position >> 3] >> (bit_position & 7)) & 1){
+                    return true;
+                }
+            }
+            for (; (bit_position + 8) <= last ; bit_position += 8){
+                if (this->data[bit_position >> 3] != 0){
+                    return true;
+                }
+            }
+            for (; bit_position < last ; bit_position++){
+                if ((this->data[bit_position >> 3] >> (bit_position & 7)) & 1){
+                    return true;
+                }
+            }
+            return false;
+        }
+        /**
+         * @brief Whether every bit of a range of any length is set.
+         */
+        inline bool all(size_t bit_position, size_t amount_of_bits){
+            if (System::Exceptions::out_of_range.test((bit_position + amount_of_bits) > AMOUNT_OF_BITS, "Position argument is not allowed by this object.") == false){
+                return false;
+            }
+            size_t last = bit_position + amount_of_bits;
+            for (; bit_position < last && (bit_position & 7) != 0 ; bit_position++){
+                if (((this->data[bit_position >> 3] >> (bit_position & 7)) & 1) == 0){
+                    return false;
+                }
+            }
+            for (; (bit_position + 8) <= last ; bit_position += 8){
+                if (this->data[bit_position >> 3] != 0xFF){
+                    return false;
+                }
+            }
+            for (; bit_position < last ; bit_position++){
+                if (((this->data[bit_position >> 3] >> (bit_position & 7)) & 1) == 0){
+                    return false;
+                }
+            }
+            return true;
+        }
         inline void clear(void){
             this->fill(false);
         }
@@ -3,4 +3,9 @@
 #include "./Bitwise.h"
 #include "./BitArray.h"
 #include "./MemoryPool.h"
+#include "./SharedMemoryPool.h"
+#include "./SlotMap.h"
+#include "./Snapshot.h"
+#include "./StaticHashMap.h"
+#include "./StructOfArrays.h"
 #include "./StaticList.h"
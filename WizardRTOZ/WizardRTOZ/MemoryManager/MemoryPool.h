@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../System/Exception.h"
+#include "../System/Trace.h"
 #include "./BitArray.h"
 
 namespace MemoryManager{
@@ -22,13 +23,35 @@ namespace MemoryManager{
         class Reference{
             friend class MemoryPool<DATA_TYPE, POOL_SIZE>;
         private:
-            MemoryPool& memory_pool;
+            MemoryPool* memory_pool {nullptr};
             DATA_TYPE* data {nullptr};
             size_t size_allocation {0};
-            inline Reference(MemoryPool& memory_pool) : memory_pool(memory_pool){}
+            inline Reference(MemoryPool& memory_pool) : memory_pool(&memory_pool){}
         public:
+            inline Reference(void) {}
+            inline Reference(Reference&& reference) : memory_pool(reference.memory_pool), data(reference.data), size_allocation(reference.size_allocation) {
+                reference.data = nullptr;
+                reference.size_allocation = 0;
+            }
+            Reference(const Reference&) = delete;
             inline ~Reference(){
-                this->memory_pool.free(*this);
+                this->release();
+            }
+            inline void release(void){
+                if (this->data != nullptr){
+                    this->memory_pool->free(*this);
+                }
+            }
+            inline bool isEmpty(void) const {
+                return (this->data == nullptr);
+            }
+
+            /**
+             * @brief Give the allocation up without freeing it. MemoryPool::adopt takes it back.
+             */
+            inline void detach(void){
+                this->data = nullptr;
+                this->size_allocation = 0;
             }
             inline size_t getTypeSize(void){
                 return sizeof(DATA_TYPE);
@@ -39,6 +62,18 @@ namespace MemoryManager{
             inline size_t getLenght(void){
                 return this->size_allocation;
             }
+
+            /**
+             * @brief Index of the first block in the pool, to adopt the allocation again after a restart.
+             *
+             * Read it before detach(): an empty reference returns POOL_SIZE, which adopt rejects.
+             */
+            inline size_t getPosition(void) const {
+                if (this->isEmpty()){
+                    return POOL_SIZE;
+                }
+                return this->data - this->memory_pool->data;
+            }
             inline void setData(DATA_TYPE data, size_t position = 0){
                 System::Exceptions::length_error.test(position >= this->size_allocation, "Invalid position.");
                 this->data[position] = data;
@@ -47,6 +82,28 @@ namespace MemoryManager{
                 System::Exceptions::length_error.test(position >= this->size_allocation, "Invalid position.");
                 return this->data[position];
             }
+
+            /**
+             * @brief Unchecked setData: an invalid position returns its status instead of raising an exception.
+             */
+            inline System::Status trySetData(DATA_TYPE data, size_t position = 0){
+                System::Status status = System::Exceptions::length_error.check(position >= this->size_allocation);
+                if (status == System::Status::ok) [[likely]] {
+                    this->data[position] = data;
+                }
+                return status;
+            }
+
+            /**
+             * @brief Unchecked getData: an invalid position returns its status instead of raising an exception.
+             */
+            inline System::Status tryGetData(DATA_TYPE*& data, size_t position = 0){
+                System::Status status = System::Exceptions::length_error.check(position >= this->size_allocation);
+                if (status == System::Status::ok) [[likely]] {
+                    data = &this->data[position];
+                }
+                return status;
+            }
             inline DATA_TYPE* begin(void){
                 return &this->data[0];
             }
@@ -63,16 +120,31 @@ namespace MemoryManager{
                 this->setData(data);
                 return *this;
             }
+            inline Reference& operator=(Reference&& reference){
+                if (this != &reference){
+                    this->release();
+                    this->memory_pool = reference.memory_pool;
+                    this->data = reference.data;
+                    this->size_allocation = reference.size_allocation;
+                    reference.data = nullptr;
+                    reference.size_allocation = 0;
+                }
+                return *this;
+            }
+            Reference& operator=(const Reference&) = delete;
         };
         inline MemoryPool(void) {}
         Reference allocate(size_t size_allocation = 1){
+            TRACE_ZONE("MemoryPool::allocate");
             System::Exceptions::length_error.test(size_allocation == 0, "Invalid allocation size.");
-            while(this->in_use_tag.get(this->allocation_position, size_allocation) != 0 && this->allocation_position < POOL_SIZE){
+            while((this->allocation_position + size_allocation) <= POOL_SIZE && this->in_use_tag.any(this->allocation_position, size_allocation)){
                 this->allocation_position++;
             }
-            System::Exceptions::out_of_range.test(this->allocation_position >= POOL_SIZE, "This memory pool is full!");
+            if (!System::Exceptions::out_of_range.guard((this->allocation_position + size_allocation) > POOL_SIZE, "This memory pool is full!")){
+                return Reference();
+            }
             DATA_TYPE* data = &this->data[this->allocation_position];
-            this->in_use_tag.set(this->allocation_position, size_allocation);
+            this->in_use_tag.fill(this->allocation_position, size_allocation, true);
             this->allocation_position += size_allocation;
             this->free_space -= size_allocation;
             Reference reference(*this);
@@ -80,7 +152,53 @@ namespace MemoryManager{
             reference.data = data;
             return reference;
         }
+
+        /**
+         * @brief Unchecked allocate: a failed allocation returns its status and leaves reference untouched.
+         */
+        System::Status tryAllocate(Reference& reference, size_t size_allocation = 1){
+            TRACE_ZONE("MemoryPool::tryAllocate");
+            System::Status status = System::Exceptions::length_error.check(size_allocation == 0 || size_allocation > POOL_SIZE);
+            if (status != System::Status::ok) [[unlikely]] {
+                return status;
+            }
+            size_t position = this->allocation_position;
+            while((position + size_allocation) <= POOL_SIZE && this->in_use_tag.any(position, size_allocation)){
+                position++;
+            }
+            status = System::Exceptions::out_of_range.check((position + size_allocation) > POOL_SIZE);
+            if (status != System::Status::ok) [[unlikely]] {
+                return status;
+            }
+            this->in_use_tag.fill(position, size_allocation, true);
+            this->allocation_position = position + size_allocation;
+            this->free_space -= size_allocation;
+            reference.release();
+            reference.memory_pool = this;
+            reference.data = &this->data[position];
+            reference.size_allocation = size_allocation;
+            return System::Status::ok;
+        }
+        /**
+         * @brief Take ownership of an allocation whose Reference is gone, such as one restored from a Snapshot.
+         *
+         * @param position The value of Reference::getPosition.
+         * @param size_allocation The value of Reference::getLenght.
+         */
+        Reference adopt(size_t position, size_t size_allocation){
+            if (!System::Exceptions::length_error.guard(size_allocation == 0 || position >= POOL_SIZE || size_allocation > POOL_SIZE - position, "Invalid allocation.")){
+                return Reference();
+            }
+            if (!System::Exceptions::domain_error.guard(!this->in_use_tag.all(position, size_allocation), "This block is not allocated in this memory pool.")){
+                return Reference();
+            }
+            Reference reference(*this);
+            reference.size_allocation = size_allocation;
+            reference.data = &this->data[position];
+            return reference;
+        }
         void free(Reference& reference){
+            TRACE_ZONE("MemoryPool::free");
             System::Exceptions::out_of_range.test(
                 (static_cast<void*>(reference.data) < this->getDataBegin<void*>() || static_cast<void*>(reference.data) > this->getDataEnd<void*>()),
                 "This data pointer is not stored in this memory pool object."
@@ -88,18 +206,32 @@ namespace MemoryManager{
             size_t free_position = static_cast<DATA_TYPE*>(reference.data) - this->getDataBegin<DATA_TYPE*>();
             this->allocation_position = free_position < this->allocation_position ? free_position : this->allocation_position;
             this->free_space += reference.size_allocation;
-            this->in_use_tag.write(free_position, 0, reference.size_allocation);
+            this->in_use_tag.fill(free_position, reference.size_allocation, false);
             reference.data = nullptr;
             reference.size_allocation = 0;
         }
         inline void setData(DATA_TYPE data, size_t position = 0){
-            System::Exceptions::length_error.test(position >= this->size_allocation, "Invalid position.");
+            System::Exceptions::length_error.test(position >= POOL_SIZE, "Invalid position.");
             this->data[position] = data;
         }
         inline DATA_TYPE& getData(size_t position = 0){
-            System::Exceptions::length_error.test(position >= this->size_allocation, "Invalid position.");
+            System::Exceptions::length_error.test(position >= POOL_SIZE, "Invalid position.");
             return this->data[position];
         }
+        inline System::Status trySetData(DATA_TYPE data, size_t position = 0){
+            System::Status status = System::Exceptions::length_error.check(position >= POOL_SIZE);
+            if (status == System::Status::ok) [[likely]] {
+                this->data[position] = data;
+            }
+            return status;
+        }
+        inline System::Status tryGetData(DATA_TYPE*& data, size_t position = 0){
+            System::Status status = System::Exceptions::length_error.check(position >= POOL_SIZE);
+            if (status == System::Status::ok) [[likely]] {
+                data = &this->data[position];
+            }
+            return status;
+        }
         size_t getFreeSpace(void){
             return this->free_space;
         }
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../System/Exception.h"
+#include "../System/Trace.h"
+
+namespace MemoryManager{
+
+    /**
+     * @class SharedMemoryPool
+     *
+     * @brief MemoryPool placed in a memory region mapped by several processes, to hand blocks
+     * over between them without copying.
+     *
+     * The in use bitmap lives in the same region as the data and is made of lock-free atomic
+     * words, so any attached process can allocate and free blocks. The region is mapped at a
+     * different address in every process, so blocks are exchanged as an Offset from the start of
+     * the data and resolved by the receiving process.
+     *
+     * @tparam DATA_TYPE The block type. It must be trivially copyable, no constructor runs in the region.
+     * @tparam POOL_SIZE The amount of blocks.
+     */
+    template <typename DATA_TYPE = uint8_t, size_t POOL_SIZE = 1>
+    class SharedMemoryPool{
+        static_assert(std::is_trivially_copyable<DATA_TYPE>::value, "Blocks of a SharedMemoryPool are shared between processes as raw memory.");
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "The in use bitmap needs address free atomics.");
+    public:
+        /**
+         * @brief Position and length of an allocation, valid in every process attached to the pool.
+         */
+        struct Offset{
+            uint64_t position;
+            uint64_t size;
+        };
+    private:
+        static constexpr uint32_t magic = 0x57535450;    ///< "WSTP"
+        static constexpr uint32_t version = 1;
+        static constexpr size_t amount_of_words = (POOL_SIZE + 63) / 64;
+
+        struct Region{
+            uint32_t magic;
+            uint32_t version;
+            uint64_t pool_size;
+            uint64_t type_size;
+            std::atomic<uint32_t> ready;
+            std::atomic<uint64_t> free_space;
+            std::atomic<uint64_t> allocation_position;
+            std::atomic<uint64_t> in_use_tag[SharedMemoryPool::amount_of_words];
+            alignas(64) DATA_TYPE data[POOL_SIZE];
+        };
+
+        Region* region {nullptr};
+
+        static inline uint64_t mask(size_t word, size_t position, size_t size){
+            size_t begin = word * 64 > position ? 0 : position - word * 64;
+            size_t end = (word + 1) * 64 < position + size ? 64 : position + size - word * 64;
+            return (end - begin == 64) ? ~uint64_t(0) : ((uint64_t(1) << (end - begin)) - 1) << begin;
+        }
+
+        inline bool isFree(size_t position, size_t size){
+            for (size_t word = position / 64 ; word <= (position + size - 1) / 64 ; word++){
+                if (this->region->in_use_tag[word].load(std::memory_order_relaxed) & SharedMemoryPool::mask(word, position, size)){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*
+         * Set the bits of [position, position + size) word by word. If another process got one of
+         * them first, the words already set are given back.
+         */
+        inline bool claim(size_t position, size_t size){
+            size_t first_word = position / 64;
+            size_t last_word = (position + size - 1) / 64;
+            for (size_t word = first_word ; word <= last_word ; word++){
+                uint64_t bits = SharedMemoryPool::mask(word, position, size);
+                uint64_t expected = this->region->in_use_tag[word].load(std::memory_order_relaxed);
+                do {
+                    if (expected & bits){
+                        for (size_t claimed = first_word ; claimed < word ; claimed++){
+                            this->region->in_use_tag[claimed].fetch_and(~SharedMemoryPool::mask(claimed, position, size), std::memory_order_release);
+                        }
+                        return false;
+                    }
+                } while (!this->region->in_use_tag[word].compare_exchange_weak(expected, expected | bits, std::memory_order_acquire, std::memory_order_relaxed));
+            }
+            return true;
+        }
+
+        /*
+         * First fit from the allocation position to the end, then from the start. The position is
+         * only a hint shared by every process, so the second pass keeps allocation exhaustive.
+         */
+        inline bool find(size_t size, size_t& position){
+            size_t hint = this->region->allocation_position.load(std::memory_order_relaxed);
+            hint = hint < POOL_SIZE ? hint : 0;
+            for (size_t pass = 0 ; pass < 2 ; pass++){
+                size_t limit = pass == 0 ? POOL_SIZE : (hint + size - 1 < POOL_SIZE ? hint + size - 1 : POOL_SIZE);
+                for (position = pass == 0 ? hint : 0 ; position + size <= limit ; position++){
+                    if (this->isFree(position, size) && this->claim(position, size)){
+                        this->region->allocation_position.store(position + size, std::memory_order_relaxed);
+                        this->region->free_space.fetch_sub(size, std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        inline void release(size_t position, size_t size){
+            for (size_t word = position / 64 ; word <= (position + size - 1) / 64 ; word++){
+                this->region->in_use_tag[word].fetch_and(~SharedMemoryPool::mask(word, position, size), std::memory_order_release);
+            }
+            this->region->free_space.fetch_add(size, std::memory_order_relaxed);
+            uint64_t hint = this->region->allocation_position.load(std::memory_order_relaxed);
+            while (position < hint && !this->region->allocation_position.compare_exchange_weak(hint, position, std::memory_order_relaxed)){}
+        }
+
+        inline bool isAllocated(const Offset& offset){
+            if (offset.size == 0 || offset.position >= POOL_SIZE || offset.size > POOL_SIZE - offset.position){
+                return false;
+            }
+            for (size_t word = offset.position / 64 ; word <= (offset.position + offset.size - 1) / 64 ; word++){
+                uint64_t bits = SharedMemoryPool::mask(word, offset.position, offset.size);
+                if ((this->region->in_use_tag[word].load(std::memory_order_relaxed) & bits) != bits){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        inline void initialize(void){
+            this->region->magic = SharedMemoryPool::magic;
+            this->region->version = SharedMemoryPool::version;
+            this->region->pool_size = POOL_SIZE;
+            this->region->type_size = sizeof(DATA_TYPE);
+            this->region->free_space.store(POOL_SIZE, std::memory_order_relaxed);
+            this->region->allocation_position.store(0, std::memory_order_relaxed);
+            for (size_t word = 0 ; word < SharedMemoryPool::amount_of_words ; word++){
+                this->region->in_use_tag[word].store(0, std::memory_order_relaxed);
+            }
+            this->region->ready.store(1, std::memory_order_release);
+        }
+    public:
+        static constexpr size_t region_size = sizeof(Region);      ///< Bytes mapped by every process
+
+        /**
+         * @class Reference
+         *
+         * @brief Owner of an allocation in the calling process, freed when it is destroyed.
+         */
+        class Reference{
+            friend class SharedMemoryPool<DATA_TYPE, POOL_SIZE>;
+        private:
+            SharedMemoryPool* memory_pool {nullptr};
+            DATA_TYPE* data {nullptr};
+            Offset offset {0, 0};
+            inline Reference(SharedMemoryPool& memory_pool, const Offset& offset) : memory_pool(&memory_pool), data(&memory_pool.region->data[offset.position]), offset(offset) {}
+        public:
+            inline Reference(void) {}
+            inline Reference(Reference&& reference) : memory_pool(reference.memory_pool), data(reference.data), offset(reference.offset) {
+                reference.data = nullptr;
+                reference.offset = {0, 0};
+            }
+            Reference(const Reference&) = delete;
+            inline ~Reference(){
+                this->release();
+            }
+            inline void release(void){
+                if (this->data != nullptr){
+                    this->memory_pool->free(*this);
+                }
+            }
+
+            /**
+             * @brief Give the allocation up without freeing it, to hand it to another process.
+             *
+             * @return The offset the receiver passes to SharedMemoryPool::adopt or SharedMemoryPool::free.
+             */
+            inline Offset detach(void){
+                Offset offset = this->offset;
+                this->data = nullptr;
+                this->offset = {0, 0};
+                return offset;
+            }
+            inline const Offset& getOffset(void) const {
+                return this->offset;
+            }
+            inline bool isEmpty(void) const {
+                return (this->data == nullptr);
+            }
+            inline size_t getLenght(void) const {
+                return this->offset.size;
+            }
+            inline size_t getDataSize(void) const {
+                return this->offset.size * sizeof(DATA_TYPE);
+            }
+            inline void setData(DATA_TYPE data, size_t position = 0){
+                System::Exceptions::length_error.test(position >= this->offset.size, "Invalid position.");
+                this->data[position] = data;
+            }
+            inline DATA_TYPE& getData(size_t position = 0){
+                System::Exceptions::length_error.test(position >= this->offset.size, "Invalid position.");
+                return this->data[position];
+            }
+            inline DATA_TYPE* begin(void){
+                return &this->data[0];
+            }
+            inline DATA_TYPE* end(void){
+                return &this->data[this->offset.size];
+            }
+            inline DATA_TYPE& operator[] (size_t position){
+                return this->getData(position);
+            }
+            inline Reference& operator=(Reference&& reference){
+                if (this != &reference){
+                    this->release();
+                    this->memory_pool = reference.memory_pool;
+                    this->data = reference.data;
+                    this->offset = reference.offset;
+                    reference.data = nullptr;
+                    reference.offset = {0, 0};
+                }
+                return *this;
+            }
+            Reference& operator=(const Reference&) = delete;
+        };
+
+        /**
+         * @brief Map an anonymous region, shared with the processes forked afterwards.
+         */
+        inline SharedMemoryPool(void){
+            void* memory = mmap(nullptr, SharedMemoryPool::region_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+            if (!System::Exceptions::runtime_error.guard(memory == MAP_FAILED, "Could not map the shared memory pool.")){
+                return;
+            }
+            this->region = static_cast<Region*>(memory);
+            this->initialize();
+        }
+
+        /**
+         * @brief Attach to the POSIX shared memory object name, creating it when it does not exist.
+         *
+         * The process that creates the object initializes it; the others wait until it is ready and
+         * check that it holds a pool of the same type and size. The object lives until remove().
+         * When any of it fails, the pool is left detached: see isAttached().
+         *
+         * @param name Name of the shared memory object, starting with '/'.
+         */
+        inline SharedMemoryPool(const char* name){
+            bool created = true;
+            int descriptor = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+            if (descriptor < 0){
+                created = false;
+                descriptor = shm_open(name, O_RDWR, 0600);
+            }
+            if (!System::Exceptions::runtime_error.guard(descriptor < 0, "Could not open the shared memory object.")){
+                return;
+            }
+            if (created){
+                if (!System::Exceptions::runtime_error.guard(ftruncate(descriptor, SharedMemoryPool::region_size) != 0, "Could not size the shared memory object.")){
+                    close(descriptor);
+                    return;
+                }
+            } else {
+                struct stat status {};
+                while (fstat(descriptor, &status) == 0 && status.st_size == 0){
+                    std::this_thread::yield();
+                }
+                if (!System::Exceptions::invalid_argument.guard(static_cast<size_t>(status.st_size) != SharedMemoryPool::region_size, "The shared memory object holds another pool.")){
+                    close(descriptor);
+                    return;
+                }
+            }
+            void* memory = mmap(nullptr, SharedMemoryPool::region_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+            close(descriptor);
+            if (!System::Exceptions::runtime_error.guard(memory == MAP_FAILED, "Could not map the shared memory pool.")){
+                return;
+            }
+            Region* region = static_cast<Region*>(memory);
+            if (created){
+                this->region = region;
+                this->initialize();
+                return;
+            }
+            while (region->ready.load(std::memory_order_acquire) == 0){
+                std::this_thread::yield();
+            }
+            if (!System::Exceptions::invalid_argument.guard(
+                region->magic != SharedMemoryPool::magic || region->version != SharedMemoryPool::version ||
+                region->pool_size != POOL_SIZE || region->type_size != sizeof(DATA_TYPE),
+                "The shared memory object holds another pool."
+            )){
+                munmap(region, SharedMemoryPool::region_size);
+                return;
+            }
+            this->region = region;
+        }
+        SharedMemoryPool(const SharedMemoryPool&) = delete;
+        SharedMemoryPool& operator=(const SharedMemoryPool&) = delete;
+        inline ~SharedMemoryPool(void){
+            if (this->region != nullptr){
+                munmap(this->region, SharedMemoryPool::region_size);
+            }
+        }
+
+        /**
+         * @brief Delete the shared memory object name. Processes still attached keep their mapping.
+         */
+        static inline void remove(const char* name){
+            shm_unlink(name);
+        }
+
+        /**
+         * @brief False when the constructor could not map the region. No other method may be called then.
+         */
+        inline bool isAttached(void) const {
+            return this->region != nullptr;
+        }
+
+        Reference allocate(size_t size_allocation = 1){
+            TRACE_ZONE("SharedMemoryPool::allocate");
+            System::Exceptions::length_error.test(size_allocation == 0 || size_allocation > POOL_SIZE, "Invalid allocation size.");
+            size_t position = 0;
+            if (!System::Exceptions::out_of_range.guard(!this->find(size_allocation, position), "This memory pool is full!")){
+                return Reference();
+            }
+            return Reference(*this, {position, size_allocation});
+        }
+
+        /**
+         * @brief Unchecked allocate: a failed allocation returns its status and leaves reference untouched.
+         */
+        System::Status tryAllocate(Reference& reference, size_t size_allocation = 1){
+            TRACE_ZONE("SharedMemoryPool::tryAllocate");
+            System::Status status = System::Exceptions::length_error.check(size_allocation == 0 || size_allocation > POOL_SIZE);
+            if (status != System::Status::ok) [[unlikely]] {
+                return status;
+            }
+            size_t position = 0;
+            status = System::Exceptions::out_of_range.check(!this->find(size_allocation, position));
+            if (status != System::Status::ok) [[unlikely]] {
+                return status;
+            }
+            reference = Reference(*this, {position, size_allocation});
+            return System::Status::ok;
+        }
+
+        /**
+         * @brief Take ownership of an allocation detached by another process.
+         */
+        Reference adopt(const Offset& offset){
+            if (!System::Exceptions::domain_error.guard(!this->isAllocated(offset), "This offset is not allocated in this memory pool.")){
+                return Reference();
+            }
+            return Reference(*this, offset);
+        }
+
+        void free(Reference& reference){
+            TRACE_ZONE("SharedMemoryPool::free");
+            System::Exceptions::out_of_range.test(reference.memory_pool != this, "This reference is not stored in this memory pool object.");
+            this->release(reference.offset.position, reference.offset.size);
+            reference.data = nullptr;
+            reference.offset = {0, 0};
+        }
+
+        /**
+         * @brief Free an allocation detached by any process.
+         */
+        void free(const Offset& offset){
+            TRACE_ZONE("SharedMemoryPool::free");
+            if (!System::Exceptions::domain_error.guard(!this->isAllocated(offset), "This offset is not allocated in this memory pool.")){
+                return;
+            }
+            this->release(offset.position, offset.size);
+        }
+
+        /**
+         * @brief Address of an allocation in the calling process.
+         */
+        inline DATA_TYPE* resolve(const Offset& offset){
+            System::Exceptions::length_error.test(offset.position >= POOL_SIZE || offset.size > POOL_SIZE - offset.position, "Invalid offset.");
+            return &this->region->data[offset.position];
+        }
+        inline size_t getFreeSpace(void){
+            return this->region->free_space.load(std::memory_order_relaxed);
+        }
+        inline size_t getTypeSize(void){
+            return sizeof(DATA_TYPE);
+        }
+        inline size_t getDataSize(void){
+            return POOL_SIZE * sizeof(DATA_TYPE);
+        }
+        inline size_t getLenght(void){
+            return POOL_SIZE;
+        }
+    };
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+#include "../System/Exception.h"
+#include "../System/Trace.h"
+
+namespace MemoryManager{
+
+    /**
+     * @class SlotMap
+     *
+     * @brief Fixed capacity container addressed by generational 32 bits handles, with its values
+     * packed at the front of one array.
+     *
+     * A handle holds a slot index in its low bits and the generation of the slot in the others.
+     * Erasing a value bumps the generation of its slot, so old handles stop resolving instead of
+     * reaching the next value stored there. Insert, erase and lookup are O(1); erase moves the
+     * last value into the hole, so iterating from begin() to end() only touches live values, in
+     * no particular order.
+     *
+     * @tparam DATA_TYPE The value type. It must be default constructible and movable.
+     * @tparam CAPACITY The maximum amount of values.
+     */
+    template <typename DATA_TYPE, size_t CAPACITY>
+    class SlotMap{
+    public:
+        static constexpr size_t index_bits = [](){
+            size_t bits = 1;
+            while ((size_t(1) << bits) < CAPACITY){
+                bits++;
+            }
+            return bits;
+        }();
+        static constexpr size_t generation_bits = 32 - SlotMap::index_bits;
+        static_assert(CAPACITY > 0 && SlotMap::index_bits <= 24, "A handle keeps at least 8 bits for the generation.");
+
+        /**
+         * @brief Generational reference to a value. Default constructed handles never resolve.
+         */
+        struct Handle{
+            uint32_t value {0};     ///< Generation 0 is never live
+            inline bool operator==(const Handle& handle) const {
+                return this->value == handle.value;
+            }
+            inline bool operator!=(const Handle& handle) const {
+                return this->value != handle.value;
+            }
+        };
+    private:
+        static constexpr uint32_t index_mask = (uint32_t(1) << SlotMap::index_bits) - 1;
+        static constexpr uint32_t end_of_list = ~uint32_t(0);
+
+        /*
+         * The generation is odd while the slot holds a value, so a handle (always made from an odd
+         * generation) of an empty slot never matches.
+         */
+        struct Slot{
+            uint32_t generation {0};
+            uint32_t position {0};     ///< Index in values while in use, next free slot otherwise
+        };
+
+        DATA_TYPE values[CAPACITY] {};
+        uint32_t owners[CAPACITY] {};  ///< Slot of each value
+        Slot slots[CAPACITY];
+        uint32_t first_free {0};
+        size_t size {0};
+
+        static inline uint32_t generationOf(uint32_t generation){
+            return generation & ((uint32_t(1) << SlotMap::generation_bits) - 1);
+        }
+        inline Slot* find(Handle handle){
+            uint32_t index = handle.value & SlotMap::index_mask;
+            if (index >= CAPACITY){
+                return nullptr;
+            }
+            Slot& slot = this->slots[index];
+            return (SlotMap::generationOf(slot.generation) == (handle.value >> SlotMap::index_bits) && (slot.generation & 1)) ? &slot : nullptr;
+        }
+        inline Handle place(uint32_t index){
+            Slot& slot = this->slots[index];
+            this->first_free = slot.position;
+            slot.generation++;
+            slot.position = static_cast<uint32_t>(this->size);
+            this->owners[this->size] = index;
+            this->size++;
+            return Handle {(SlotMap::generationOf(slot.generation) << SlotMap::index_bits) | index};
+        }
+    public:
+        inline SlotMap(void){
+            this->clear();
+        }
+
+        /**
+         * @brief Store value.
+         *
+         * @return Its handle, or a default handle when the map is full.
+         */
+        Handle insert(DATA_TYPE value){
+            TRACE_ZONE("SlotMap::insert");
+            if (!System::Exceptions::out_of_range.guard(this->first_free == SlotMap::end_of_list, "This slot map is full!")){
+                return Handle();
+            }
+            this->values[this->size] = std::move(value);
+            return this->place(this->first_free);
+        }
+
+        /**
+         * @brief Unchecked insert: a full map returns its status and leaves handle untouched.
+         */
+        System::Status tryInsert(Handle& handle, DATA_TYPE value){
+            System::Status status = System::Exceptions::out_of_range.check(this->first_free == SlotMap::end_of_list);
+            if (status == System::Status::ok) [[likely]] {
+                this->values[this->size] = std::move(value);
+                handle = this->place(this->first_free);
+            }
+            return status;
+        }
+
+        /**
+         * @brief Remove the value of handle, moving the last value into its place.
+         *
+         * @return False when handle does not resolve.
+         */
+        bool erase(Handle handle){
+            TRACE_ZONE("SlotMap::erase");
+            Slot* slot = this->find(handle);
+            if (slot == nullptr){
+                return false;
+            }
+            uint32_t position = slot->position;
+            uint32_t last = static_cast<uint32_t>(this->size - 1);
+            if (position != last){
+                this->values[position] = std::move(this->values[last]);
+                this->owners[position] = this->owners[last];
+                this->slots[this->owners[position]].position = position;
+            }
+            this->values[last] = DATA_TYPE();
+            this->size--;
+            slot->generation++;
+            slot->position = this->first_free;
+            this->first_free = handle.value & SlotMap::index_mask;
+            return true;
+        }
+
+        /**
+         * @brief Value of handle, or nullptr when it was erased or never inserted.
+         */
+        inline DATA_TYPE* get(Handle handle){
+            Slot* slot = this->find(handle);
+            return slot == nullptr ? nullptr : &this->values[slot->position];
+        }
+        inline bool contains(Handle handle){
+            return this->find(handle) != nullptr;
+        }
+        inline DATA_TYPE& operator[](Handle handle){
+            DATA_TYPE* value = this->get(handle);
+            System::Exceptions::domain_error.test(value == nullptr, "This handle does not belong to a value of this slot map.");
+            return *value;
+        }
+
+        /**
+         * @brief Handle of the value at position of the packed array, to erase while iterating.
+         */
+        inline Handle getHandle(size_t position){
+            System::Exceptions::length_error.test(position >= this->size, "Invalid position.");
+            uint32_t index = this->owners[position];
+            return Handle {(SlotMap::generationOf(this->slots[index].generation) << SlotMap::index_bits) | index};
+        }
+
+        /**
+         * @brief Erase every value. Handles given before never resolve again.
+         */
+        void clear(void){
+            for (size_t position = 0 ; position < this->size ; position++){
+                this->values[position] = DATA_TYPE();
+            }
+            for (size_t index = 0 ; index < CAPACITY ; index++){
+                Slot& slot = this->slots[index];
+                slot.generation += slot.generation & 1;
+                slot.position = index + 1 < CAPACITY ? static_cast<uint32_t>(index + 1) : SlotMap::end_of_list;
+            }
+            this->first_free = 0;
+            this->size = 0;
+        }
+        inline size_t getSize(void) const {
+            return this->size;
+        }
+        inline size_t getCapacity(void) const {
+            return CAPACITY;
+        }
+        inline bool isEmpty(void) const {
+            return this->size == 0;
+        }
+        inline DATA_TYPE* begin(void){
+            return &this->values[0];
+        }
+        inline DATA_TYPE* end(void){
+            return &this->values[this->size];
+        }
+    };
+}
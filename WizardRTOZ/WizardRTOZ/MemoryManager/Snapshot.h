@@ -0,0 +1,193 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../System/Exception.h"
+
+namespace MemoryManager{
+
+    /**
+     * @class Snapshot
+     *
+     * @brief Keeps an object, such as a MemoryPool or a BitArray, in a memory mapped file so a
+     * restarted process maps its previous state instead of rebuilding it.
+     *
+     * The file holds a versioned header followed by the object. attach() accepts the previous
+     * state only when the header matches and the last snapshot() was not followed by any change,
+     * without reading the object: the kernel pages it in as it is used. attach() and the first
+     * non-const access after every snapshot() mark the file dirty before the object can change, so
+     * a crash in between is detected as an unclean file. Pointers into the object kept across
+     * snapshot() bypass that: get them again, or call touch(), before writing through them.
+     * Objects holding pointers cannot be restored; MemoryPool references are adopted again from
+     * their position and length.
+     *
+     * @tparam OBJECT_TYPE The stored type. It must be default constructible, with a standard layout
+     * and no pointers; its destructor is never run.
+     */
+    template <typename OBJECT_TYPE>
+    class Snapshot{
+        static_assert(std::is_standard_layout<OBJECT_TYPE>::value, "A Snapshot stores its object as raw bytes.");
+        static_assert(alignof(OBJECT_TYPE) <= 64, "The object of a Snapshot is placed 64 bytes after the start of the file.");
+    public:
+        static constexpr uint32_t format_version = 1;
+    private:
+        static constexpr uint64_t magic = 0x544F4E5350414E53ull;     ///< "SNAPSNOT"
+
+        struct Header{
+            uint64_t magic;
+            uint32_t format_version;
+            uint32_t version;
+            uint64_t object_size;
+            uint64_t checksum;
+            uint32_t clean;
+        };
+        static constexpr size_t data_offset = (sizeof(Header) + 63) / 64 * 64;
+        static constexpr size_t file_size = Snapshot::data_offset + sizeof(OBJECT_TYPE);
+
+        const uint32_t version;
+        int file_descriptor {-1};
+        uint8_t* memory {nullptr};
+
+        inline Header* getHeader(void){
+            return reinterpret_cast<Header*>(this->memory);
+        }
+
+        /*
+         * Multiply and xor-shift over 64 bits words, several times faster than a byte wise hash.
+         */
+        static inline uint64_t hash(const uint8_t* data, size_t size){
+            uint64_t result = 0xCBF29CE484222325ull ^ size;
+            size_t index = 0;
+            for (; index + 8 <= size ; index += 8){
+                uint64_t word;
+                memcpy(&word, data + index, 8);
+                result = ((result ^ word) * 0x100000001B3ull);
+                result ^= result >> 29;
+            }
+            for (; index < size ; index++){
+                result = (result ^ data[index]) * 0x100000001B3ull;
+            }
+            return result;
+        }
+    public:
+        /**
+         * @brief Map the file at path, creating it when it does not exist. The object is not usable
+         * before attach().
+         *
+         * @param path File holding the snapshot.
+         * @param version Layout version of the application data, a mismatch discards the file.
+         */
+        Snapshot(const char* path, uint32_t version = 0) : version(version) {
+            this->file_descriptor = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+            if (!System::Exceptions::runtime_error.guard(this->file_descriptor < 0, "Could not open the snapshot file.")){
+                return;
+            }
+            struct stat status {};
+            fstat(this->file_descriptor, &status);
+            if (static_cast<size_t>(status.st_size) != Snapshot::file_size){
+                if (!System::Exceptions::runtime_error.guard(ftruncate(this->file_descriptor, 0) != 0 || ftruncate(this->file_descriptor, Snapshot::file_size) != 0, "Could not size the snapshot file.")){
+                    return;
+                }
+            }
+            void* memory = mmap(nullptr, Snapshot::file_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->file_descriptor, 0);
+            if (!System::Exceptions::runtime_error.guard(memory == MAP_FAILED, "Could not map the snapshot file.")){
+                return;
+            }
+            this->memory = static_cast<uint8_t*>(memory);
+        }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        ~Snapshot(void){
+            if (this->memory != nullptr){
+                munmap(this->memory, Snapshot::file_size);
+            }
+            if (this->file_descriptor >= 0){
+                close(this->file_descriptor);
+            }
+        }
+
+        /**
+         * @brief Restore the object of the last snapshot(), or construct a new one.
+         *
+         * @param verify Also check the checksum of the object, which reads all of it.
+         *
+         * @return True when the previous state was restored.
+         */
+        bool attach(bool verify = false){
+            if (!System::Exceptions::runtime_error.guard(this->memory == nullptr, "The snapshot file is not mapped.")){
+                return false;
+            }
+            Header* header = this->getHeader();
+            bool restored = header->magic == Snapshot::magic && header->format_version == Snapshot::format_version &&
+                header->version == this->version && header->object_size == sizeof(OBJECT_TYPE) && header->clean == 1;
+            if (restored && verify){
+                restored = Snapshot::hash(this->memory + Snapshot::data_offset, sizeof(OBJECT_TYPE)) == header->checksum;
+            }
+            header->clean = 0;
+            msync(this->memory, sizeof(Header), MS_SYNC);
+            if (restored == false){
+                new (this->memory + Snapshot::data_offset) OBJECT_TYPE();
+            }
+            return restored;
+        }
+
+        /**
+         * @brief Write the object and a header describing it to the file. The object stays usable,
+         * the next non-const access marks the file dirty again.
+         */
+        void snapshot(void){
+            if (!System::Exceptions::runtime_error.guard(this->memory == nullptr, "The snapshot file is not mapped.")){
+                return;
+            }
+            Header* header = this->getHeader();
+            msync(this->memory, Snapshot::file_size, MS_SYNC);
+            header->magic = Snapshot::magic;
+            header->format_version = Snapshot::format_version;
+            header->version = this->version;
+            header->object_size = sizeof(OBJECT_TYPE);
+            header->checksum = Snapshot::hash(this->memory + Snapshot::data_offset, sizeof(OBJECT_TYPE));
+            header->clean = 1;
+            msync(this->memory, sizeof(Header), MS_SYNC);
+        }
+
+        /**
+         * @brief Mark the object as changed since the last snapshot(). The non-const accessors call
+         * it; the flag reaches the file before the object can change, as in attach().
+         */
+        inline void touch(void){
+            Header* header = this->getHeader();
+            if (header->clean != 0) [[unlikely]] {
+                header->clean = 0;
+                msync(this->memory, sizeof(Header), MS_SYNC);
+            }
+        }
+        inline OBJECT_TYPE& get(void){
+            this->touch();
+            return *reinterpret_cast<OBJECT_TYPE*>(this->memory + Snapshot::data_offset);
+        }
+        inline const OBJECT_TYPE& get(void) const {
+            return *reinterpret_cast<const OBJECT_TYPE*>(this->memory + Snapshot::data_offset);
+        }
+        inline OBJECT_TYPE* operator->(void){
+            return &this->get();
+        }
+        inline const OBJECT_TYPE* operator->(void) const {
+            return &this->get();
+        }
+        inline OBJECT_TYPE& operator*(void){
+            return this->get();
+        }
+        inline const OBJECT_TYPE& operator*(void) const {
+            return this->get();
+        }
+    };
+}
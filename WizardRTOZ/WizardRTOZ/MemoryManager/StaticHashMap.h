@@ -0,0 +1,268 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "../System/Exception.h"
+
+namespace MemoryManager{
+
+    /**
+     * @class StaticHashMap
+     *
+     * @brief Fixed capacity hash map with open addressing and Robin Hood probing, without any
+     * dynamic allocation.
+     *
+     * Every bucket keeps its distance from the bucket its key hashes to. An insertion takes the
+     * place of any entry closer to home than itself, which keeps probe sequences short even close
+     * to a full table, and lets a lookup stop at the first entry closer to home than the key would
+     * be. Erasing shifts the following entries one bucket back instead of leaving tombstones, so
+     * lookups never slow down after many erases.
+     *
+     * @tparam KEY_TYPE The key type. It must be default constructible and comparable with ==.
+     * @tparam VALUE_TYPE The value type. It must be default constructible.
+     * @tparam CAPACITY The amount of buckets, a power of two. Every bucket can be used.
+     * @tparam HASH Hash function object of the keys. Its result is mixed before use, so identity
+     * hashes are fine.
+     */
+    template <typename KEY_TYPE, typename VALUE_TYPE, size_t CAPACITY, typename HASH = std::hash<KEY_TYPE>>
+    class StaticHashMap{
+        static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "The capacity of a StaticHashMap must be a power of two.");
+    public:
+        struct Entry{
+            KEY_TYPE key {};
+            VALUE_TYPE value {};
+        };
+
+        /**
+         * @class Iterator
+         *
+         * @brief Walks the used buckets, in no particular order.
+         */
+        class Iterator{
+            friend class StaticHashMap;
+        private:
+            StaticHashMap* map;
+            size_t position;
+            inline Iterator(StaticHashMap* map, size_t position) : map(map), position(position) {
+                this->skip();
+            }
+            inline void skip(void){
+                while (this->position < CAPACITY && this->map->distances[this->position] == 0){
+                    this->position++;
+                }
+            }
+        public:
+            inline Entry& operator*(void) const {
+                return this->map->entries[this->position];
+            }
+            inline Entry* operator->(void) const {
+                return &this->map->entries[this->position];
+            }
+            inline Iterator& operator++(void){
+                this->position++;
+                this->skip();
+                return *this;
+            }
+            inline bool operator==(const Iterator& iterator) const {
+                return this->position == iterator.position;
+            }
+            inline bool operator!=(const Iterator& iterator) const {
+                return this->position != iterator.position;
+            }
+        };
+    private:
+        /*
+         * 0 marks an empty bucket, otherwise the probe distance plus one. A distance never exceeds
+         * the capacity, so the narrowest type that holds it keeps the metadata compact.
+         */
+        using Distance = typename std::conditional<(CAPACITY < 0xFF), uint8_t, typename std::conditional<(CAPACITY < 0xFFFF), uint16_t, uint32_t>::type>::type;
+        static constexpr size_t mask = CAPACITY - 1;
+
+        Distance distances[CAPACITY] {};
+        Entry entries[CAPACITY] {};
+        size_t size {0};
+
+        /*
+         * Handed out by operator[] for a key that does not fit, so the write is lost instead of
+         * overflowing the table.
+         */
+        VALUE_TYPE overflow {};
+
+        static constexpr size_t index_bits = [](){
+            size_t bits = 0;
+            while ((size_t(1) << bits) < CAPACITY){
+                bits++;
+            }
+            return bits;
+        }();
+
+        /*
+         * Fibonacci hashing: the top bits of the product depend on every bit of the hash, so
+         * HASH may vary in any bits (std::hash of integers is the identity).
+         */
+        static inline size_t home(const KEY_TYPE& key){
+            if constexpr (StaticHashMap::index_bits == 0){
+                (void) key;
+                return 0;
+            } else {
+                uint64_t hash = static_cast<uint64_t>(HASH()(key)) * 0x9E3779B97F4A7C15ull;
+                return static_cast<size_t>(hash >> (64 - StaticHashMap::index_bits));
+            }
+        }
+        /*
+         * Only an entry as far from home as the probe can hold key, which skips most key loads.
+         */
+        inline size_t locate(const KEY_TYPE& key) const {
+            size_t position = StaticHashMap::home(key);
+            for (size_t distance = 1 ; this->distances[position] >= distance ; distance++){
+                if (this->distances[position] == distance && this->entries[position].key == key){
+                    return position;
+                }
+                position = (position + 1) & StaticHashMap::mask;
+            }
+            return CAPACITY;
+        }
+
+        /*
+         * Insert a key known to be absent into a table known to have room.
+         */
+        inline VALUE_TYPE* place(KEY_TYPE key, VALUE_TYPE value){
+            Entry carried {std::move(key), std::move(value)};
+            size_t distance = 1;
+            size_t position = StaticHashMap::home(carried.key);
+            VALUE_TYPE* placed = nullptr;
+            while (this->distances[position] != 0){
+                if (this->distances[position] < distance){
+                    std::swap(carried, this->entries[position]);
+                    Distance displaced = this->distances[position];
+                    this->distances[position] = static_cast<Distance>(distance);
+                    distance = displaced;
+                    if (placed == nullptr){
+                        placed = &this->entries[position].value;
+                    }
+                }
+                position = (position + 1) & StaticHashMap::mask;
+                distance++;
+            }
+            this->entries[position] = std::move(carried);
+            this->distances[position] = static_cast<Distance>(distance);
+            this->size++;
+            return placed == nullptr ? &this->entries[position].value : placed;
+        }
+    public:
+        inline StaticHashMap(void) {}
+
+        /**
+         * @brief Store value under key, replacing the value already stored under it.
+         *
+         * @return The stored value, or nullptr when the map is full.
+         */
+        VALUE_TYPE* insert(KEY_TYPE key, VALUE_TYPE value){
+            size_t position = this->locate(key);
+            if (position != CAPACITY){
+                this->entries[position].value = std::move(value);
+                return &this->entries[position].value;
+            }
+            if (!System::Exceptions::out_of_range.guard(this->size == CAPACITY, "This hash map is full!")){
+                return nullptr;
+            }
+            return this->place(std::move(key), std::move(value));
+        }
+
+        /**
+         * @brief Unchecked insert: a full map returns its status instead of raising an exception.
+         */
+        System::Status tryInsert(KEY_TYPE key, VALUE_TYPE value){
+            size_t position = this->locate(key);
+            if (position != CAPACITY){
+                this->entries[position].value = std::move(value);
+                return System::Status::ok;
+            }
+            System::Status status = System::Exceptions::out_of_range.check(this->size == CAPACITY);
+            if (status == System::Status::ok) [[likely]] {
+                this->place(std::move(key), std::move(value));
+            }
+            return status;
+        }
+
+        /**
+         * @brief Value stored under key, or nullptr.
+         */
+        inline VALUE_TYPE* find(const KEY_TYPE& key){
+            size_t position = this->locate(key);
+            return position == CAPACITY ? nullptr : &this->entries[position].value;
+        }
+        inline bool contains(const KEY_TYPE& key) const {
+            return this->locate(key) != CAPACITY;
+        }
+
+        /**
+         * @brief Value stored under key, inserting a default value when there is none.
+         *
+         * When the map is full and key is not stored, a default value kept outside of the table
+         * is returned instead and the map is left unchanged.
+         */
+        inline VALUE_TYPE& operator[](const KEY_TYPE& key){
+            size_t position = this->locate(key);
+            if (position != CAPACITY){
+                return this->entries[position].value;
+            }
+            if (!System::Exceptions::out_of_range.guard(this->size == CAPACITY, "This hash map is full!")){
+                this->overflow = VALUE_TYPE();
+                return this->overflow;
+            }
+            return *this->place(key, VALUE_TYPE());
+        }
+
+        /**
+         * @brief Remove key, shifting the entries probed after it one bucket back.
+         *
+         * @return False when key is not stored.
+         */
+        bool erase(const KEY_TYPE& key){
+            size_t position = this->locate(key);
+            if (position == CAPACITY){
+                return false;
+            }
+            size_t next = (position + 1) & StaticHashMap::mask;
+            while (this->distances[next] > 1){
+                this->entries[position] = std::move(this->entries[next]);
+                this->distances[position] = this->distances[next] - 1;
+                position = next;
+                next = (next + 1) & StaticHashMap::mask;
+            }
+            this->entries[position] = Entry();
+            this->distances[position] = 0;
+            this->size--;
+            return true;
+        }
+        void clear(void){
+            for (size_t position = 0 ; position < CAPACITY ; position++){
+                if (this->distances[position] != 0){
+                    this->entries[position] = Entry();
+                    this->distances[position] = 0;
+                }
+            }
+            this->size = 0;
+        }
+        inline size_t getSize(void) const {
+            return this->size;
+        }
+        inline size_t getCapacity(void) const {
+            return CAPACITY;
+        }
+        inline bool isEmpty(void) const {
+            return this->size == 0;
+        }
+        inline Iterator begin(void){
+            return Iterator(this, 0);
+        }
+        inline Iterator end(void){
+            return Iterator(this, CAPACITY);
+        }
+    };
+}
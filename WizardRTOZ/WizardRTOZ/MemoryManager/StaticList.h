@@ -4,6 +4,7 @@
 #include <stdint.h>
 
 #include "../System/Exception.h"
+#include "../System/Trace.h"
 
 namespace MemoryManager{
 
@@ -29,6 +30,12 @@ namespace MemoryManager{
             inline void setData(const DATA_TYPE data){
                 this->data = data;
             }
+            inline Element* getNext(void) const {
+                return this->next_item;
+            }
+            inline uint8_t getPriority(void) const {
+                return this->priority;
+            }
             inline operator DATA_TYPE&() const {
                 return this->data;
             }
@@ -38,8 +45,9 @@ namespace MemoryManager{
             }
         };
         StaticList(){};
-        inline size_t append(Element& element, std::function<bool(const System::Exception&)> error_callback = [](const System::Exception&){ return false; })
+        inline size_t append(Element& element, System::FunctionReference<bool(const System::Exception&)> error_callback = nullptr)
         {
+            TRACE_ZONE("StaticList::append");
             System::Exceptions::domain_error.test(element.storing_list != nullptr, "The argument element is not contained in this list object.", error_callback);
 
             element.storing_list = this;
@@ -50,6 +58,7 @@ namespace MemoryManager{
              */
             if (this->first_item == nullptr){
                 this->first_item = &element;
+                this->last_item = &element;
                 element.next_item = nullptr;
                 element.previous_item = nullptr;
                 return 0;
@@ -87,17 +96,20 @@ namespace MemoryManager{
                 return position;
             }
         }
-        inline size_t remove(Element& element, std::function<bool(const System::Exception&)> error_callback = [](const System::Exception&){ return false; }){
+        inline size_t remove(Element& element, System::FunctionReference<bool(const System::Exception&)> error_callback = nullptr){
+            TRACE_ZONE("StaticList::remove");
             System::Exceptions::domain_error.test(element.storing_list != this, "The argument element must be contained in this list object.", error_callback);
 
-            Element* previous_item = element.previous_item;
-
             if (element.previous_item != nullptr){
                 element.previous_item->next_item = element.next_item;
+            } else {
+                this->first_item = element.next_item;
             }
 
             if (element.next_item != nullptr){
                 element.next_item->previous_item = element.previous_item;
+            } else {
+                this->last_item = element.previous_item;
             }
 
             element.next_item = nullptr;
@@ -105,26 +117,11 @@ namespace MemoryManager{
             element.storing_list = nullptr;
             return --this->lenght;
         }
-        inline size_t remove(size_t position, std::function<bool(const System::Exception&)> error_callback = [](const System::Exception&){ return false; }){
+        inline size_t remove(size_t position, System::FunctionReference<bool(const System::Exception&)> error_callback = nullptr){
             System::Exceptions::out_of_range.test(position >= this->lenght, "Invalid position.", error_callback);
-            Element* buffer = this->first_item;
-
-            if (position == 0){
-                this->first_item->storing_list = nullptr;
-                this->first_item = buffer->next_item;
-            }
-            else
-            {
-                for (size_t counter = 0 ; counter < position - 1 ; counter ++){
-                    buffer = buffer->next_item;
-                }
-                buffer->next_item->storing_list = nullptr;
-                buffer->next_item = buffer->next_item->next_item;
-            }
-
-            return --this->lenght;
+            return this->remove(this->get(position), error_callback);
         }
-        inline Element& get(size_t position, std::function<bool(const System::Exception&)> error_callback = [](const System::Exception&){ return false; }){
+        inline Element& get(size_t position, System::FunctionReference<bool(const System::Exception&)> error_callback = nullptr){
             System::Exceptions::out_of_range.test(position >= this->lenght, "Invalid position.", error_callback);
 
             Element* buffer = this->first_item;
@@ -135,6 +132,12 @@ namespace MemoryManager{
 
             return *buffer;
         }
+        inline size_t getLenght(void) const {
+            return this->lenght;
+        }
+        inline Element* getFirst(void) const {
+            return this->first_item;
+        }
         inline Element& operator[](size_t position){
             return this->get(position);
         }
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tuple>
+#include <utility>
+
+#include "../System/Exception.h"
+
+namespace MemoryManager{
+
+    /**
+     * @class StructOfArrays
+     *
+     * @brief Fixed capacity table stored column by column, for loops over many records that only
+     * read a few of their fields.
+     *
+     * Every field of the list has its own contiguous column aligned to a cache line, so a kernel
+     * over getColumn() spans reads only the bytes it uses and can be vectorized by the compiler.
+     * Rows stay packed at the front of the columns: remove() moves the last row into the hole.
+     * Columns are addressed by their position in the field list, usually through an enum.
+     *
+     * @tparam CAPACITY The maximum amount of rows.
+     * @tparam FIELD_TYPES The type of every column. They must be default constructible.
+     */
+    template <size_t CAPACITY, typename... FIELD_TYPES>
+    class StructOfArrays{
+        static_assert(sizeof...(FIELD_TYPES) > 0, "A StructOfArrays needs at least one field.");
+    public:
+        static constexpr size_t alignment = 64;    ///< Alignment of every column, in bytes
+
+        template <size_t COLUMN> using FieldType = typename std::tuple_element<COLUMN, std::tuple<FIELD_TYPES...>>::type;
+
+        /**
+         * @brief Contiguous view of the used part of a column.
+         */
+        template <typename DATA_TYPE> struct Span{
+            DATA_TYPE* data;
+            size_t size;
+            inline DATA_TYPE& operator[](size_t position) const {
+                return this->data[position];
+            }
+            inline DATA_TYPE* begin(void) const {
+                return this->data;
+            }
+            inline DATA_TYPE* end(void) const {
+                return this->data + this->size;
+            }
+        };
+
+        /**
+         * @class Row
+         *
+         * @brief Proxy to the fields of one row. It is invalidated by remove().
+         */
+        class Row{
+            friend class StructOfArrays;
+        private:
+            StructOfArrays* table;
+            size_t position;
+            inline Row(StructOfArrays* table, size_t position) : table(table), position(position) {}
+        public:
+            template <size_t COLUMN> inline FieldType<COLUMN>& get(void) const {
+                return std::get<COLUMN>(this->table->columns).data[this->position];
+            }
+            inline void set(FIELD_TYPES... values) const {
+                this->table->write(this->position, std::index_sequence_for<FIELD_TYPES...>(), std::move(values)...);
+            }
+            inline size_t getPosition(void) const {
+                return this->position;
+            }
+        };
+    private:
+        template <typename DATA_TYPE> struct alignas(StructOfArrays::alignment) Column{
+            DATA_TYPE data[CAPACITY] {};
+        };
+
+        std::tuple<Column<FIELD_TYPES>...> columns;
+        size_t size {0};
+
+        template <size_t... COLUMNS> inline void write(size_t position, std::index_sequence<COLUMNS...>, FIELD_TYPES... values){
+            ((std::get<COLUMNS>(this->columns).data[position] = std::move(values)), ...);
+        }
+        template <size_t... COLUMNS> inline void move(size_t destination, size_t source, std::index_sequence<COLUMNS...>){
+            ((std::get<COLUMNS>(this->columns).data[destination] = std::move(std::get<COLUMNS>(this->columns).data[source])), ...);
+        }
+
+        /*
+         * Give the fields of a vacated row back their default value, so it does not keep a
+         * moved-from object or the resources of a removed one.
+         */
+        template <size_t... COLUMNS> inline void reset(size_t position, std::index_sequence<COLUMNS...>){
+            ((std::get<COLUMNS>(this->columns).data[position] = FIELD_TYPES()), ...);
+        }
+    public:
+        inline StructOfArrays(void) {}
+
+        /**
+         * @brief Add a row at the end of the columns.
+         *
+         * @return The position of the row, or CAPACITY when the table is full.
+         */
+        size_t append(FIELD_TYPES... values){
+            if (!System::Exceptions::out_of_range.guard(this->size == CAPACITY, "This table is full!")){
+                return CAPACITY;
+            }
+            this->write(this->size, std::index_sequence_for<FIELD_TYPES...>(), std::move(values)...);
+            return this->size++;
+        }
+
+        /**
+         * @brief Unchecked append: a full table returns its status instead of raising an exception.
+         */
+        System::Status tryAppend(FIELD_TYPES... values){
+            if (this->size == CAPACITY) [[unlikely]] {
+                return System::Exceptions::out_of_range.getStatus();
+            }
+            this->write(this->size++, std::index_sequence_for<FIELD_TYPES...>(), std::move(values)...);
+            return System::Status::ok;
+        }
+
+        /**
+         * @brief Remove the row at position, moving the last row into its place.
+         */
+        void remove(size_t position){
+            if (!System::Exceptions::length_error.test(position >= this->size, "Invalid position.")){
+                return;
+            }
+            this->size--;
+            if (position != this->size){
+                this->move(position, this->size, std::index_sequence_for<FIELD_TYPES...>());
+            }
+            this->reset(this->size, std::index_sequence_for<FIELD_TYPES...>());
+        }
+        void clear(void){
+            for (size_t position = 0 ; position < this->size ; position++){
+                this->reset(position, std::index_sequence_for<FIELD_TYPES...>());
+            }
+            this->size = 0;
+        }
+
+        /**
+         * @brief The used part of column COLUMN, aligned to StructOfArrays::alignment bytes.
+         */
+        template <size_t COLUMN> inline Span<FieldType<COLUMN>> getColumn(void){
+            return {std::get<COLUMN>(this->columns).data, this->size};
+        }
+        inline Row getRow(size_t position){
+            System::Exceptions::length_error.test(position >= this->size, "Invalid position.");
+            return Row(this, position);
+        }
+        inline Row operator[](size_t position){
+            return this->getRow(position);
+        }
+        inline size_t getSize(void) const {
+            return this->size;
+        }
+        inline size_t getCapacity(void) const {
+            return CAPACITY;
+        }
+        inline bool isEmpty(void) const {
+            return this->size == 0;
+        }
+    };
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+#include "./WaitQueue.h"
+
+namespace Synchronization{
+
+    /**
+     * @class EventFlags
+     *
+     * @brief 32 event flags that threads can wait on, any or all of a mask at a time.
+     *
+     * set only touches the WaitQueue when a thread is parked; satisfied waiters are released
+     * in priority order, so a waiter that clears the flags on exit starves the ones behind it.
+     */
+    class EventFlags{
+    public:
+        enum class Mode : uint8_t {
+            any,    ///< Wake when at least one flag of the mask is set
+            all,    ///< Wake when every flag of the mask is set
+        };
+    private:
+        static constexpr uint32_t mode_all = (1 << 0);
+        static constexpr uint32_t clear_on_exit = (1 << 1);
+
+        std::atomic<uint32_t> flags;
+        std::atomic<uint32_t> amount_of_waiters {0};
+        WaitQueue wait_queue;
+        const uint32_t spin_limit;
+
+        static inline bool isSatisfied(uint32_t flags, uint32_t mask, Mode mode){
+            return (mode == Mode::all) ? ((flags & mask) == mask) : ((flags & mask) != 0);
+        }
+        inline bool consume(uint32_t mask, Mode mode, bool clear, uint32_t& result){
+            uint32_t flags = this->flags.load(std::memory_order_acquire);
+            while (EventFlags::isSatisfied(flags, mask, mode)){
+                if (clear == false){
+                    result = flags;
+                    return true;
+                }
+                if (this->flags.compare_exchange_weak(flags, flags & ~mask, std::memory_order_acq_rel, std::memory_order_acquire)){
+                    result = flags;
+                    return true;
+                }
+            }
+            return false;
+        }
+    public:
+        inline EventFlags(uint32_t initial_flags = 0, uint32_t spin_limit = 100) : flags(initial_flags), spin_limit(spin_limit) {}
+        EventFlags(const EventFlags&) = delete;
+        EventFlags& operator=(const EventFlags&) = delete;
+
+        /**
+         * @brief Wait until the flags of mask are set.
+         *
+         * @param mask The flags to wait for.
+         * @param mode Whether any or all of the flags are required.
+         * @param clear Clear the flags of mask when the wait is satisfied.
+         * @param priority Priority used if the caller has to sleep. Lower values are served first.
+         *
+         * @return The flags that satisfied the wait.
+         */
+        inline uint32_t wait(uint32_t mask, Mode mode = Mode::any, bool clear = false, uint8_t priority = 0){
+            uint32_t result = 0;
+            if (this->consume(mask, mode, clear, result)){
+                return result;
+            }
+            this->wait_queue.countSpin();
+            for (uint32_t spin = 0 ; spin < this->spin_limit ; spin++){
+                Synchronization::pause();
+                if (this->consume(mask, mode, clear, result)){
+                    return result;
+                }
+            }
+            this->wait_queue.lock();
+            this->amount_of_waiters.fetch_add(1, std::memory_order_seq_cst);
+            if (this->consume(mask, mode, clear, result)){
+                this->amount_of_waiters.fetch_sub(1, std::memory_order_relaxed);
+                this->wait_queue.unlock();
+                return result;
+            }
+            WaitQueue::Waiter waiter;
+            waiter.argument = mask;
+            waiter.options = (mode == Mode::all ? EventFlags::mode_all : 0) | (clear ? EventFlags::clear_on_exit : 0);
+            this->wait_queue.park(waiter, priority);
+            return waiter.result;
+        }
+
+        /**
+         * @brief Set the flags of mask and release the waiters they satisfy.
+         *
+         * @return The flags after the call.
+         */
+        inline uint32_t set(uint32_t mask){
+            uint32_t flags = this->flags.fetch_or(mask, std::memory_order_seq_cst) | mask;
+            if (this->amount_of_waiters.load(std::memory_order_seq_cst) == 0){
+                return flags;
+            }
+            this->wait_queue.lock();
+            auto* element = this->wait_queue.getFirst();
+            while (element != nullptr){
+                auto* next = element->getNext();
+                WaitQueue::Waiter& waiter = element->getData();
+                Mode mode = (waiter.options & EventFlags::mode_all) ? Mode::all : Mode::any;
+                uint32_t result = 0;
+                if (this->consume(waiter.argument, mode, waiter.options & EventFlags::clear_on_exit, result)){
+                    this->amount_of_waiters.fetch_sub(1, std::memory_order_relaxed);
+                    waiter.result = result;
+                    this->wait_queue.wake(*element);
+                }
+                element = next;
+            }
+            this->wait_queue.unlock();
+            return this->flags.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Clear the flags of mask.
+         *
+         * @return The flags before the call.
+         */
+        inline uint32_t clear(uint32_t mask){
+            return this->flags.fetch_and(~mask, std::memory_order_acq_rel);
+        }
+        inline uint32_t get(void) const {
+            return this->flags.load(std::memory_order_acquire);
+        }
+        inline ContentionCounters getContentionCounters(void) const {
+            return this->wait_queue.getContentionCounters();
+        }
+    };
+}
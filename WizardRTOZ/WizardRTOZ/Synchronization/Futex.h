@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @namespace Synchronization
+ *
+ * @brief Namespace containing primitives to coordinate concurrent tasks.
+ */
+namespace Synchronization{
+
+    /**
+     * @brief Hint the core that the caller is busy waiting.
+     */
+    inline void pause(void){
+        #if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+        #elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+        #endif
+    }
+
+    /**
+     * @class Futex
+     *
+     * @brief Park and wake threads on a 32 bits word, backed by the Linux futex system call.
+     *
+     * Other platforms fall back to yielding, which keeps the primitives correct but not efficient.
+     */
+    class Futex{
+    public:
+        /**
+         * @brief Sleep while word holds expected. May return spuriously.
+         *
+         * @param word The word to sleep on.
+         * @param expected The value that keeps the caller asleep.
+         * @param timeout Maximum sleep in nanoseconds, 0 to sleep until woken.
+         */
+        static inline void wait(std::atomic<uint32_t>& word, uint32_t expected, uint64_t timeout = 0){
+            #if defined(__linux__)
+            struct timespec time_limit = {static_cast<time_t>(timeout / 1000000000), static_cast<long>(timeout % 1000000000)};
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, timeout == 0 ? nullptr : &time_limit, nullptr, 0);
+            #else
+            (void) timeout;
+            if (word.load(std::memory_order_acquire) == expected){
+                std::this_thread::yield();
+            }
+            #endif
+        }
+
+        /**
+         * @brief Wake up to amount_of_threads threads sleeping on word.
+         */
+        static inline void wake(std::atomic<uint32_t>& word, int amount_of_threads = 1){
+            #if defined(__linux__)
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, amount_of_threads, nullptr, nullptr, 0);
+            #else
+            (void) word;
+            (void) amount_of_threads;
+            #endif
+        }
+    };
+}
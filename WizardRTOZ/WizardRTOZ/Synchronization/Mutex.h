@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+#include "./WaitQueue.h"
+
+namespace Synchronization{
+
+    /**
+     * @class Mutex
+     *
+     * @brief Adaptive mutex: spins briefly with a pause instruction and then parks in the kernel.
+     *
+     * An uncontended lock/unlock pair costs one atomic operation each and no system call.
+     * When threads are parked, unlock wakes the first waiter of the priority ordered WaitQueue,
+     * which then competes for the mutex again instead of receiving it, to avoid lock convoys.
+     */
+    class Mutex{
+    private:
+        static constexpr uint32_t unlocked = 0;
+        static constexpr uint32_t locked = 1;
+        static constexpr uint32_t locked_with_waiters = 2;
+
+        std::atomic<uint32_t> state {Mutex::unlocked};
+        WaitQueue wait_queue;
+        const uint32_t spin_limit;
+
+        inline bool acquire(void){
+            uint32_t expected = Mutex::unlocked;
+            return this->state.compare_exchange_strong(expected, Mutex::locked, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+    public:
+        inline Mutex(uint32_t spin_limit = 100) : spin_limit(spin_limit) {}
+        Mutex(const Mutex&) = delete;
+        Mutex& operator=(const Mutex&) = delete;
+
+        inline bool tryLock(void){
+            return this->acquire();
+        }
+
+        /**
+         * @brief Take the mutex.
+         *
+         * @param priority Priority used if the caller has to sleep. Lower values are served first.
+         */
+        inline void lock(uint8_t priority = 0){
+            if (this->acquire()){
+                return;
+            }
+            this->wait_queue.countSpin();
+            for (uint32_t spin = 0 ; spin < this->spin_limit ; spin++){
+                Synchronization::pause();
+                if (this->state.load(std::memory_order_relaxed) == Mutex::unlocked && this->acquire()){
+                    return;
+                }
+            }
+            while (true){
+                this->wait_queue.lock();
+                if (this->state.exchange(Mutex::locked_with_waiters, std::memory_order_acquire) == Mutex::unlocked){
+                    this->wait_queue.unlock();
+                    return;
+                }
+                WaitQueue::Waiter waiter;
+                this->wait_queue.park(waiter, priority);
+            }
+        }
+
+        inline void unlock(void){
+            if (this->state.exchange(Mutex::unlocked, std::memory_order_release) == Mutex::locked){
+                return;
+            }
+            this->wait_queue.lock();
+            if (this->wait_queue.isEmpty() == false){
+                this->wait_queue.wake(*this->wait_queue.getFirst());
+            }
+            this->wait_queue.unlock();
+        }
+
+        inline ContentionCounters getContentionCounters(void) const {
+            return this->wait_queue.getContentionCounters();
+        }
+    };
+
+    /**
+     * @class LockGuard
+     *
+     * @brief Hold a Mutex for the lifetime of the object.
+     */
+    class LockGuard{
+    private:
+        Mutex& mutex;
+    public:
+        inline LockGuard(Mutex& mutex, uint8_t priority = 0) : mutex(mutex) {
+            this->mutex.lock(priority);
+        }
+        inline ~LockGuard(void){
+            this->mutex.unlock();
+        }
+        LockGuard(const LockGuard&) = delete;
+        LockGuard& operator=(const LockGuard&) = delete;
+    };
+}
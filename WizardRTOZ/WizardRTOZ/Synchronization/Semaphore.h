@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+#include "./WaitQueue.h"
+
+namespace Synchronization{
+
+    /**
+     * @class Semaphore
+     *
+     * @brief Counting semaphore that spins briefly and then parks in the kernel.
+     *
+     * release only touches the WaitQueue when a thread is parked; tokens released while
+     * threads are parked are handed to them in priority order.
+     */
+    class Semaphore{
+    private:
+        std::atomic<int32_t> count;
+        std::atomic<uint32_t> amount_of_waiters {0};
+        WaitQueue wait_queue;
+        const uint32_t spin_limit;
+
+        inline bool take(void){
+            int32_t count = this->count.load(std::memory_order_relaxed);
+            while (count > 0){
+                if (this->count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed)){
+                    return true;
+                }
+            }
+            return false;
+        }
+    public:
+        inline Semaphore(int32_t initial_count = 0, uint32_t spin_limit = 100) : count(initial_count), spin_limit(spin_limit) {}
+        Semaphore(const Semaphore&) = delete;
+        Semaphore& operator=(const Semaphore&) = delete;
+
+        inline bool tryAcquire(void){
+            return this->take();
+        }
+
+        /**
+         * @brief Take one token, waiting for it if needed.
+         *
+         * @param priority Priority used if the caller has to sleep. Lower values are served first.
+         */
+        inline void acquire(uint8_t priority = 0){
+            if (this->take()){
+                return;
+            }
+            this->wait_queue.countSpin();
+            for (uint32_t spin = 0 ; spin < this->spin_limit ; spin++){
+                Synchronization::pause();
+                if (this->take()){
+                    return;
+                }
+            }
+            this->wait_queue.lock();
+            this->amount_of_waiters.fetch_add(1, std::memory_order_seq_cst);
+            if (this->take()){
+                this->amount_of_waiters.fetch_sub(1, std::memory_order_relaxed);
+                this->wait_queue.unlock();
+                return;
+            }
+            WaitQueue::Waiter waiter;
+            this->wait_queue.park(waiter, priority);
+        }
+
+        /**
+         * @brief Give back amount_of_tokens tokens.
+         */
+        inline void release(int32_t amount_of_tokens = 1){
+            this->count.fetch_add(amount_of_tokens, std::memory_order_seq_cst);
+            if (this->amount_of_waiters.load(std::memory_order_seq_cst) == 0){
+                return;
+            }
+            this->wait_queue.lock();
+            while (this->wait_queue.isEmpty() == false && this->take()){
+                this->amount_of_waiters.fetch_sub(1, std::memory_order_relaxed);
+                this->wait_queue.wake(*this->wait_queue.getFirst());
+            }
+            this->wait_queue.unlock();
+        }
+
+        inline int32_t getCount(void) const {
+            return this->count.load(std::memory_order_relaxed);
+        }
+        inline ContentionCounters getContentionCounters(void) const {
+            return this->wait_queue.getContentionCounters();
+        }
+    };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+#include "./Futex.h"
+
+namespace Synchronization{
+
+    /**
+     * @class SpinLock
+     *
+     * @brief Test and test-and-set lock for critical sections of a few instructions.
+     *
+     * After spin_limit pauses the waiter yields its core, in case the owner was preempted.
+     */
+    class SpinLock{
+    private:
+        static constexpr uint32_t spin_limit = 64;
+        std::atomic<bool> locked {false};
+    public:
+        inline bool tryLock(void){
+            return !this->locked.load(std::memory_order_relaxed) && !this->locked.exchange(true, std::memory_order_acquire);
+        }
+        inline void lock(void){
+            while (this->locked.exchange(true, std::memory_order_acquire)){
+                for (uint32_t spin = 0 ; this->locked.load(std::memory_order_relaxed) ; spin++){
+                    if (spin < SpinLock::spin_limit){
+                        Synchronization::pause();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+        inline void unlock(void){
+            this->locked.store(false, std::memory_order_release);
+        }
+    };
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "./Futex.h"
+#include "./SpinLock.h"
+#include "./WaitQueue.h"
+#include "./Mutex.h"
+#include "./Semaphore.h"
+#include "./EventFlags.h"
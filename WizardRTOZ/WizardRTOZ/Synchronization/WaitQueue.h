@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "../MemoryManager/StaticList.h"
+#include "./Futex.h"
+#include "./SpinLock.h"
+
+namespace Synchronization{
+
+    /**
+     * @struct ContentionCounters
+     *
+     * @brief Snapshot of how often a primitive could not be taken right away.
+     */
+    struct ContentionCounters{
+        uint64_t spun {0};      ///< Acquisitions that had to spin
+        uint64_t parked {0};    ///< Acquisitions that had to sleep in the kernel
+    };
+
+    /**
+     * @class WaitQueue
+     *
+     * @brief Priority ordered queue of parked threads.
+     *
+     * Waiters are kept in a MemoryManager::StaticList, so they are served in the same order
+     * as its elements: lower priority values first and arrival order among equal priorities.
+     * The queue is guarded by a spin lock that callers take around their own state checks.
+     */
+    class WaitQueue{
+    public:
+        class Waiter{
+            friend class WaitQueue;
+        private:
+            std::atomic<uint32_t> signaled {0};
+            Waiter* next_signaled {nullptr};
+        public:
+            uint32_t argument {0};  ///< Free for the primitive (for instance a flag mask)
+            uint32_t options {0};   ///< Free for the primitive (for instance a wait mode)
+            uint32_t result {0};    ///< Written by the waker before the waiter is released
+        };
+    private:
+        SpinLock spin_lock;
+        MemoryManager::StaticList<Waiter> waiters;
+        Waiter* signaled_waiters {nullptr};
+        std::atomic<uint64_t> spun {0};
+        std::atomic<uint64_t> parked {0};
+    public:
+        inline void lock(void){
+            this->spin_lock.lock();
+        }
+
+        /**
+         * @brief Release the lock and then signal the waiters woken while it was held.
+         *
+         * Signaling after the release keeps a woken thread from preempting the waker and then
+         * spinning on a lock that is still held.
+         */
+        inline void unlock(void){
+            Waiter* waiter = this->signaled_waiters;
+            this->signaled_waiters = nullptr;
+            this->spin_lock.unlock();
+            while (waiter != nullptr){
+                Waiter* next = waiter->next_signaled;
+                waiter->signaled.store(1, std::memory_order_release);
+                Futex::wake(waiter->signaled);
+                waiter = next;
+            }
+        }
+
+        /**
+         * @brief Queue the calling thread, release the lock and sleep until it is woken.
+         *
+         * @param waiter The waiter owned by the calling thread.
+         * @param priority The priority of the waiter.
+         */
+        inline void park(Waiter& waiter, uint8_t priority){
+            typename MemoryManager::StaticList<Waiter>::Element element(waiter, priority);
+            this->waiters.append(element);
+            this->unlock();
+            this->parked.fetch_add(1, std::memory_order_relaxed);
+            while (waiter.signaled.load(std::memory_order_acquire) == 0){
+                Futex::wait(waiter.signaled, 0);
+            }
+        }
+
+        /**
+         * @brief First waiter to be served, or nullptr. The lock must be held.
+         */
+        inline typename MemoryManager::StaticList<Waiter>::Element* getFirst(void) const {
+            return this->waiters.getFirst();
+        }
+
+        /**
+         * @brief Dequeue a waiter, which runs once the lock is released. The lock must be held.
+         */
+        inline void wake(typename MemoryManager::StaticList<Waiter>::Element& element){
+            Waiter& waiter = element.getData();
+            this->waiters.remove(element);
+            waiter.next_signaled = this->signaled_waiters;
+            this->signaled_waiters = &waiter;
+        }
+
+        inline bool isEmpty(void) const {
+            return this->waiters.getLenght() == 0;
+        }
+        inline void countSpin(void){
+            this->spun.fetch_add(1, std::memory_order_relaxed);
+        }
+        inline ContentionCounters getContentionCounters(void) const {
+            ContentionCounters counters;
+            counters.spun = this->spun.load(std::memory_order_relaxed);
+            counters.parked = this->parked.load(std::memory_order_relaxed);
+            return counters;
+        }
+    };
+}
@@ -0,0 +1,234 @@
+#include "./AsyncOutput.h"
+#include "../Synchronization/Futex.h"
+#include "./Trace.h"
+
+#include <limits.h>
+#include <string.h>
+
+using namespace System;
+
+AsyncOutput::AsyncOutput(char* data, size_t capacity, int file_descriptor, OverflowPolicy policy, uint64_t flush_interval)
+    : data(data), capacity(capacity), file_sink(file_descriptor), destination(this->file_sink), policy(policy), flush_interval(flush_interval) {
+    if (this->policy == OverflowPolicy::overwrite){
+        this->scratch = new char[this->capacity];
+    }
+    this->flusher = std::thread(&AsyncOutput::run, this);
+}
+
+AsyncOutput::AsyncOutput(char* data, size_t capacity, Sink& destination, OverflowPolicy policy, uint64_t flush_interval)
+    : data(data), capacity(capacity), file_sink(-1), destination(destination), policy(policy), flush_interval(flush_interval) {
+    if (this->policy == OverflowPolicy::overwrite){
+        this->scratch = new char[this->capacity];
+    }
+    this->flusher = std::thread(&AsyncOutput::run, this);
+}
+
+AsyncOutput::~AsyncOutput(void){
+    this->flush();
+    this->running.store(false, std::memory_order_seq_cst);
+    this->wakeFlusher();
+    this->flusher.join();
+    delete[] this->scratch;
+}
+
+bool AsyncOutput::write(const struct iovec* fragments, size_t amount_of_fragments){
+    size_t size = 0;
+    for (size_t index = 0 ; index < amount_of_fragments ; index++){
+        size += fragments[index].iov_len;
+    }
+    if (size > this->capacity){
+        bool complete = true;
+        for (size_t index = 0 ; index < amount_of_fragments ; index++){
+            complete = this->writePieces(static_cast<const char*>(fragments[index].iov_base), fragments[index].iov_len) && complete;
+        }
+        return complete;
+    }
+    uint64_t position = 0;
+    if (size == 0){
+        return true;
+    }
+    if (this->reserve(size, position) == false){
+        return false;
+    }
+    uint64_t fragment_position = position;
+    for (size_t index = 0 ; index < amount_of_fragments ; index++){
+        this->copy(fragment_position, static_cast<const char*>(fragments[index].iov_base), fragments[index].iov_len);
+        fragment_position += fragments[index].iov_len;
+    }
+    this->commit(position, size);
+    return true;
+}
+
+bool AsyncOutput::writePieces(const char* message, size_t size){
+    bool complete = true;
+    while (size > 0){
+        size_t piece = size < this->capacity ? size : this->capacity;
+        uint64_t position = 0;
+        if (this->reserve(piece, position)){
+            this->copy(position, message, piece);
+            this->commit(position, piece);
+        } else {
+            complete = false;
+        }
+        message += piece;
+        size -= piece;
+    }
+    return complete;
+}
+
+void AsyncOutput::copy(uint64_t position, const char* message, size_t size){
+    size_t offset = position & (this->capacity - 1);
+    size_t first = size < (this->capacity - offset) ? size : (this->capacity - offset);
+    memcpy(this->data + offset, message, first);
+    memcpy(this->data, message + first, size - first);
+}
+
+void AsyncOutput::commit(uint64_t position, size_t size){
+    /*
+     * Publish in reservation order, so the flusher never sees a hole.
+     */
+    for (uint32_t spin = 0 ; this->committed.load(std::memory_order_acquire) != position ; spin++){
+        if (spin < 64){
+            Synchronization::pause();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    this->committed.store(position + size, std::memory_order_seq_cst);
+    uint32_t state = this->flusher_state.load(std::memory_order_seq_cst);
+    if (state == AsyncOutput::idle || (state == AsyncOutput::batching && (position + size - this->tail.load(std::memory_order_relaxed)) >= (this->capacity >> 1))){
+        this->wakeFlusher();
+    }
+}
+
+void AsyncOutput::flush(void){
+    uint64_t target = this->head.load(std::memory_order_acquire);
+    uint64_t current = this->flush_target.load(std::memory_order_relaxed);
+    while (current < target && !this->flush_target.compare_exchange_weak(current, target, std::memory_order_seq_cst)){}
+    this->waitWritten(target);
+}
+
+void AsyncOutput::wakeFlusher(void){
+    if (this->flusher_state.exchange(AsyncOutput::awake, std::memory_order_seq_cst) != AsyncOutput::awake){
+        Synchronization::Futex::wake(this->flusher_state);
+    }
+}
+
+void AsyncOutput::waitWritten(uint64_t position){
+    this->waiting_writers.fetch_add(1, std::memory_order_seq_cst);
+    while (this->tail.load(std::memory_order_acquire) < position){
+        uint32_t sequence = this->written_sequence.load(std::memory_order_seq_cst);
+        if (this->tail.load(std::memory_order_seq_cst) >= position){
+            break;
+        }
+        this->wakeFlusher();
+        Synchronization::Futex::wait(this->written_sequence, sequence, this->flush_interval);
+    }
+    this->waiting_writers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool AsyncOutput::reserve(size_t size, uint64_t& position){
+    uint64_t head = this->head.load(std::memory_order_relaxed);
+    while (true){
+        uint64_t tail = this->tail.load(std::memory_order_acquire);
+        if ((head + size - tail) > this->capacity){
+            if (this->policy == OverflowPolicy::drop){
+                this->dropped.fetch_add(size, std::memory_order_relaxed);
+                return false;
+            }
+            uint64_t needed_tail = head + size - this->capacity;
+            if (this->policy == OverflowPolicy::block){
+                this->waitWritten(needed_tail);
+            } else if (this->committed.load(std::memory_order_acquire) < needed_tail){
+                /*
+                 * The oldest bytes are reserved by a writer still copying them: discarding them
+                 * would hand the same ring bytes to both writers, so wait for the commit.
+                 */
+                std::this_thread::yield();
+            } else if (this->tail.compare_exchange_weak(tail, needed_tail, std::memory_order_acq_rel)){
+                this->dropped.fetch_add(needed_tail - tail, std::memory_order_relaxed);
+            }
+            head = this->head.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (this->head.compare_exchange_weak(head, head + size, std::memory_order_acq_rel, std::memory_order_relaxed)){
+            position = head;
+            return true;
+        }
+    }
+}
+
+void AsyncOutput::run(void){
+    while (true){
+        while (this->drain() != 0){}
+        if (this->running.load(std::memory_order_acquire) == false){
+            break;
+        }
+        this->sleep(AsyncOutput::idle, 0);
+        this->sleep(AsyncOutput::batching, this->flush_interval);
+    }
+    while (this->committed.load(std::memory_order_acquire) != this->head.load(std::memory_order_acquire) || this->drain() != 0){}
+}
+
+void AsyncOutput::sleep(uint32_t state, uint64_t timeout){
+    this->flusher_state.store(state, std::memory_order_seq_cst);
+    uint64_t tail = this->tail.load(std::memory_order_seq_cst);
+    uint64_t committed = this->committed.load(std::memory_order_seq_cst);
+    bool pending = (this->running.load(std::memory_order_seq_cst) == false) || (committed > tail && (
+        state == AsyncOutput::idle ||
+        (committed - tail) >= (this->capacity >> 1) ||
+        this->flush_target.load(std::memory_order_seq_cst) > tail
+    ));
+    if (pending == false){
+        Synchronization::Futex::wait(this->flusher_state, state, timeout);
+    }
+    this->flusher_state.store(AsyncOutput::awake, std::memory_order_relaxed);
+}
+
+size_t AsyncOutput::drain(void){
+    uint64_t tail = this->tail.load(std::memory_order_acquire);
+    uint64_t committed = this->committed.load(std::memory_order_acquire);
+    if (committed <= tail){
+        return 0;
+    }
+    TRACE_ZONE("AsyncOutput::drain");
+    size_t size = committed - tail;
+    TRACE_COUNTER("AsyncOutput::pending", size);
+    size_t offset = tail & (this->capacity - 1);
+    size_t first = size < (this->capacity - offset) ? size : (this->capacity - offset);
+
+    if (this->policy != OverflowPolicy::overwrite){
+        this->emit(this->data + offset, first, this->data, size - first);
+        this->tail.store(committed, std::memory_order_release);
+    } else {
+        /*
+         * Writers may overwrite the range while it is copied: they move the tail before they
+         * write, so every byte behind the tail read after the copy is discarded.
+         */
+        memcpy(this->scratch, this->data + offset, first);
+        memcpy(this->scratch + first, this->data, size - first);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t current_tail = this->tail.load(std::memory_order_relaxed);
+        size_t skip = current_tail > tail ? (current_tail - tail) : 0;
+        if (skip < size){
+            this->emit(this->scratch + skip, size - skip, nullptr, 0);
+        }
+        while (current_tail < committed && !this->tail.compare_exchange_weak(current_tail, committed, std::memory_order_acq_rel)){}
+    }
+
+    this->written_sequence.fetch_add(1, std::memory_order_seq_cst);
+    if (this->waiting_writers.load(std::memory_order_seq_cst) != 0){
+        Synchronization::Futex::wake(this->written_sequence, INT_MAX);
+    }
+    return size;
+}
+
+void AsyncOutput::emit(const char* first, size_t first_size, const char* second, size_t second_size){
+    struct iovec fragments[2] = {
+        {const_cast<char*>(first), first_size},
+        {const_cast<char*>(second), second_size},
+    };
+    if (this->destination.write(fragments, second_size == 0 ? 1 : 2) == false){
+        this->dropped.fetch_add(first_size + second_size, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+#include "./Sink.h"
+
+namespace System{
+
+    /**
+     * @enum OverflowPolicy
+     *
+     * @brief What a writer does when the AsyncOutput ring is full.
+     */
+    enum class OverflowPolicy : uint8_t {
+        block,      ///< Wait for the flusher to make room
+        drop,       ///< Discard the new message
+        overwrite,  ///< Discard the oldest unwritten bytes
+    };
+
+    /**
+     * @class AsyncOutput
+     *
+     * @brief Lock-free multi-producer byte ring drained by a background flusher thread.
+     *
+     * Writers reserve a contiguous range with one compare-and-swap, copy their message and
+     * publish it in reservation order, so messages are never interleaved. Once a byte is queued
+     * the flusher sleeps until the ring is half full, flush() is called or flush_interval
+     * elapses, and then hands everything available to the destination sink as (at most) two
+     * fragments, one writev(2) for a FileSink.
+     */
+    class AsyncOutput : public Sink{
+    private:
+        static constexpr uint32_t awake = 0;
+        static constexpr uint32_t idle = 1;        ///< Flusher sleeps until a byte is written
+        static constexpr uint32_t batching = 2;    ///< Flusher sleeps until the ring is half full or flush_interval elapses
+
+        char* const data;
+        const size_t capacity;
+        FileSink file_sink;
+        Sink& destination;
+        const OverflowPolicy policy;
+        const uint64_t flush_interval;
+        char* scratch {nullptr};                    ///< Copy of the bytes being written, used by OverflowPolicy::overwrite
+
+        alignas(64) std::atomic<uint64_t> head {0};         ///< End of the reserved bytes
+        alignas(64) std::atomic<uint64_t> committed {0};    ///< End of the bytes ready to be written
+        alignas(64) std::atomic<uint64_t> tail {0};         ///< End of the bytes already written
+        std::atomic<uint32_t> flusher_state {AsyncOutput::awake};  ///< Futex the flusher sleeps on
+        std::atomic<uint32_t> written_sequence {0};         ///< Futex writers waiting for room or for flush() sleep on
+        std::atomic<uint32_t> waiting_writers {0};
+        std::atomic<uint64_t> flush_target {0};
+        std::atomic<uint64_t> dropped {0};
+        std::atomic<bool> running {true};
+        std::thread flusher;
+
+        void wakeFlusher(void);
+        void waitWritten(uint64_t position);
+        bool reserve(size_t size, uint64_t& position);
+        void copy(uint64_t position, const char* message, size_t size);
+        void commit(uint64_t position, size_t size);
+        bool writePieces(const char* message, size_t size);
+        void run(void);
+        void sleep(uint32_t state, uint64_t timeout);
+        size_t drain(void);
+        void emit(const char* first, size_t first_size, const char* second, size_t second_size);
+    public:
+        /**
+         * @param data Storage of the ring.
+         * @param capacity Size of data in bytes. It must be a power of two.
+         * @param file_descriptor Destination of the bytes.
+         * @param policy What writers do when the ring is full.
+         * @param flush_interval Longest time in nanoseconds a byte waits in the ring.
+         */
+        AsyncOutput(char* data, size_t capacity, int file_descriptor = 1, OverflowPolicy policy = OverflowPolicy::block, uint64_t flush_interval = 10000000);
+
+        /**
+         * @param destination Sink the flusher thread writes to. It must outlive the AsyncOutput.
+         */
+        AsyncOutput(char* data, size_t capacity, Sink& destination, OverflowPolicy policy = OverflowPolicy::block, uint64_t flush_interval = 10000000);
+        ~AsyncOutput(void);
+        AsyncOutput(const AsyncOutput&) = delete;
+        AsyncOutput& operator=(const AsyncOutput&) = delete;
+
+        using Sink::write;
+
+        /**
+         * @brief Queue the fragments as one message. Safe from any thread.
+         *
+         * Messages larger than the ring are queued in ring sized pieces, which other writers may interleave.
+         *
+         * @return False when the policy discarded (part of) the message.
+         */
+        bool write(const struct iovec* fragments, size_t amount_of_fragments) override;
+
+        /**
+         * @brief Wait until every byte queued before the call reached the destination.
+         */
+        void flush(void) override;
+
+        /**
+         * @brief OverflowPolicy::overwrite discards bytes, not messages, so it may cut them.
+         */
+        inline bool preservesMessages(void) const override {
+            return this->policy != OverflowPolicy::overwrite;
+        }
+
+        /**
+         * @brief Amount of bytes discarded by the overflow policy.
+         */
+        inline uint64_t getDropped(void) const {
+            return this->dropped.load(std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @class AsyncOutputBuffer
+     *
+     * @brief AsyncOutput owning a ring of CAPACITY bytes.
+     */
+    template <size_t CAPACITY>
+    class AsyncOutputBuffer : public AsyncOutput{
+        static_assert(CAPACITY >= 64 && (CAPACITY & (CAPACITY - 1)) == 0, "The capacity must be a power of two.");
+    private:
+        char storage[CAPACITY];
+    public:
+        inline AsyncOutputBuffer(int file_descriptor = 1, OverflowPolicy policy = OverflowPolicy::block, uint64_t flush_interval = 10000000)
+            : AsyncOutput(this->storage, CAPACITY, file_descriptor, policy, flush_interval) {}
+        inline AsyncOutputBuffer(Sink& destination, OverflowPolicy policy = OverflowPolicy::block, uint64_t flush_interval = 10000000)
+            : AsyncOutput(this->storage, CAPACITY, destination, policy, flush_interval) {}
+    };
+}
@@ -0,0 +1,520 @@
+#include "./BinaryLog.h"
+#include "./Exception.h"
+#include "../Synchronization/Futex.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace System;
+
+constexpr char BinaryLog::magic[8];
+std::atomic<Sink*> BinaryLog::output {nullptr};
+std::atomic<BinaryLog::Ring*> BinaryLog::first {nullptr};
+thread_local BinaryLog::Owner BinaryLog::owner;
+std::atomic<BinaryLog::Format*> BinaryLog::Format::first {nullptr};
+std::atomic<uint16_t> BinaryLog::Format::last_id {0};
+
+namespace {
+    struct Entry{
+        std::vector<uint8_t> codes;
+        std::string format;
+    };
+
+    /*
+     * Reads a block without going past its end: a dump comes from a file and may be corrupt.
+     * A load past the end returns zeros and marks the reader failed.
+     */
+    struct Reader{
+        const uint8_t* cursor;
+        const uint8_t* const end;
+        bool failed {false};
+
+        inline Reader(const uint8_t* cursor, const uint8_t* end) : cursor(cursor), end(end) {}
+
+        template <typename DATA_TYPE> DATA_TYPE load(void){
+            DATA_TYPE value {};
+            if (this->failed || static_cast<size_t>(this->end - this->cursor) < sizeof(DATA_TYPE)){
+                this->failed = true;
+                return value;
+            }
+            memcpy(&value, this->cursor, sizeof(DATA_TYPE));
+            this->cursor += sizeof(DATA_TYPE);
+            return value;
+        }
+        uint64_t varint(void){
+            uint64_t value = 0;
+            for (unsigned shift = 0 ; shift < 64 ; shift += 7){
+                uint8_t byte = this->load<uint8_t>();
+                if (this->failed){
+                    return 0;
+                }
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0){
+                    return value;
+                }
+            }
+            this->failed = true;
+            return 0;
+        }
+        int64_t zigzag(void){
+            uint64_t value = this->varint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+        const uint8_t* skip(size_t size){
+            const uint8_t* begin = this->cursor;
+            if (this->failed || static_cast<size_t>(this->end - this->cursor) < size){
+                this->failed = true;
+                return nullptr;
+            }
+            this->cursor += size;
+            return begin;
+        }
+        const char* string(void){
+            const void* terminator = this->failed ? nullptr : memchr(this->cursor, 0, this->end - this->cursor);
+            if (terminator == nullptr){
+                this->failed = true;
+                return nullptr;
+            }
+            const char* begin = reinterpret_cast<const char*>(this->cursor);
+            this->cursor = static_cast<const uint8_t*>(terminator) + 1;
+            return begin;
+        }
+
+        /*
+         * Step over the arguments of an entry, to find where the next one starts.
+         */
+        bool skipArguments(const uint8_t* codes, size_t amount_of_arguments){
+            for (size_t argument = 0 ; argument < amount_of_arguments && this->failed == false ; argument++){
+                switch (static_cast<BinaryLog::Type>(codes[argument])){
+                    case BinaryLog::Type::character: this->skip(1); break;
+                    case BinaryLog::Type::f32: this->skip(4); break;
+                    case BinaryLog::Type::f64: this->skip(8); break;
+                    case BinaryLog::Type::pointer: this->skip(8); break;
+                    case BinaryLog::Type::string: this->skip(this->load<uint8_t>()); break;
+                    default: this->varint(); break;
+                }
+            }
+            return this->failed == false;
+        }
+    };
+
+    /*
+     * State of the drain, guarded by drain_mutex.
+     */
+    std::mutex drain_mutex;
+    std::vector<const BinaryLog::Format*> formats;      ///< Indexed by id
+    std::vector<bool> written;                          ///< Formats whose dictionary reached the current output
+    size_t amount_of_written {0};
+    std::vector<uint8_t> block;
+
+    std::thread drainer;
+    std::atomic<bool> draining {false};
+    std::atomic<uint32_t> wake_sequence {0};
+
+    /*
+     * Pair of (ticks, nanoseconds) taken at the first open(), to convert ticks to time.
+     */
+    uint64_t calibration_ticks = 0;
+    uint64_t calibration_time = 0;
+
+    uint64_t monotonicTime(void){
+        struct timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+    }
+
+    template <typename DATA_TYPE> void append(std::vector<uint8_t>& data, const DATA_TYPE& value){
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(DATA_TYPE));
+    }
+    void beginBlock(std::vector<uint8_t>& data, BinaryLog::Block kind){
+        data.clear();
+        append(data, static_cast<uint8_t>(kind));
+        append(data, uint32_t(0));
+    }
+    void endBlock(std::vector<uint8_t>& data, Sink& output){
+        uint32_t body_size = static_cast<uint32_t>(data.size() - BinaryLog::block_header_size);
+        memcpy(data.data() + 1, &body_size, sizeof(body_size));
+        output.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+}
+
+BinaryLog::Format::Format(const char* format, const char* file, uint32_t line, const uint8_t* codes, uint8_t amount_of_arguments)
+    : id(BinaryLog::Format::last_id.fetch_add(1, std::memory_order_relaxed) + 1), format(format), file(file), line(line), codes(codes), amount_of_arguments(amount_of_arguments) {
+    this->next = BinaryLog::Format::first.load(std::memory_order_relaxed);
+    while (!BinaryLog::Format::first.compare_exchange_weak(this->next, this, std::memory_order_release, std::memory_order_relaxed)){}
+}
+
+BinaryLog::Owner::~Owner(void){
+    if (this->ring != nullptr){
+        this->ring->state.store(BinaryLog::retired, std::memory_order_release);
+    }
+}
+
+bool BinaryLog::open(Sink& output, uint64_t flush_interval){
+    if (!Exceptions::invalid_argument.guard(output.preservesMessages() == false, "BinaryLog records cannot be written to a sink that cuts messages.")){
+        return false;
+    }
+    BinaryLog::close();
+    {
+        std::lock_guard<std::mutex> lock(drain_mutex);
+        if (calibration_ticks == 0){
+            calibration_time = monotonicTime();
+            calibration_ticks = Trace::now();
+        }
+        written.clear();
+        amount_of_written = 0;
+        output.write(BinaryLog::magic, sizeof(BinaryLog::magic));
+    }
+    BinaryLog::output.store(&output, std::memory_order_release);
+    draining.store(true, std::memory_order_release);
+    drainer = std::thread([flush_interval](){
+        while (draining.load(std::memory_order_acquire)){
+            uint32_t sequence = wake_sequence.load(std::memory_order_acquire);
+            {
+                std::lock_guard<std::mutex> lock(drain_mutex);
+                Sink* output = BinaryLog::output.load(std::memory_order_acquire);
+                if (output != nullptr){
+                    BinaryLog::drain(*output);
+                }
+            }
+            Synchronization::Futex::wait(wake_sequence, sequence, flush_interval);
+        }
+    });
+    return true;
+}
+
+void BinaryLog::close(void){
+    Sink* output = BinaryLog::output.exchange(nullptr, std::memory_order_acq_rel);
+    if (output == nullptr){
+        return;
+    }
+    draining.store(false, std::memory_order_release);
+    BinaryLog::wake();
+    drainer.join();
+    std::lock_guard<std::mutex> lock(drain_mutex);
+    BinaryLog::drain(*output);
+    output->flush();
+}
+
+void BinaryLog::flush(void){
+    std::lock_guard<std::mutex> lock(drain_mutex);
+    Sink* output = BinaryLog::output.load(std::memory_order_acquire);
+    if (output != nullptr){
+        BinaryLog::drain(*output);
+        output->flush();
+    }
+}
+
+uint64_t BinaryLog::getDropped(void){
+    uint64_t dropped = 0;
+    for (Ring* ring = BinaryLog::first.load(std::memory_order_acquire) ; ring != nullptr ; ring = ring->next){
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void BinaryLog::wake(void){
+    wake_sequence.fetch_add(1, std::memory_order_release);
+    Synchronization::Futex::wake(wake_sequence);
+}
+
+bool BinaryLog::copy(Ring& ring, uint64_t head, const uint8_t* entry, size_t size){
+    if (head + size - ring.cached_tail > BinaryLog::ring_capacity){
+        ring.cached_tail = ring.tail.load(std::memory_order_acquire);
+        if (head + size - ring.cached_tail > BinaryLog::ring_capacity){
+            ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    size_t offset = head & (BinaryLog::ring_capacity - 1);
+    size_t first = size < (BinaryLog::ring_capacity - offset) ? size : (BinaryLog::ring_capacity - offset);
+    memcpy(ring.data + offset, entry, first);
+    memcpy(ring.data, entry + first, size - first);
+    return true;
+}
+
+BinaryLog::Ring* BinaryLog::acquire(void){
+    Ring* ring = nullptr;
+    for (Ring* iterator = BinaryLog::first.load(std::memory_order_acquire) ; iterator != nullptr ; iterator = iterator->next){
+        uint8_t state = BinaryLog::reusable;
+        if (iterator->state.load(std::memory_order_relaxed) == BinaryLog::reusable && iterator->state.compare_exchange_strong(state, BinaryLog::owned, std::memory_order_acquire)){
+            ring = iterator;
+            break;
+        }
+    }
+    if (ring == nullptr){
+        ring = new Ring();
+        ring->next = BinaryLog::first.load(std::memory_order_relaxed);
+        while (!BinaryLog::first.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed)){}
+    }
+    BinaryLog::owner.ring = ring;
+    BinaryLog::local_ring = ring;
+    return ring;
+}
+
+void BinaryLog::drain(Sink& output){
+    bool clocked = false;
+    for (Ring* ring = BinaryLog::first.load(std::memory_order_acquire) ; ring != nullptr ; ring = ring->next){
+        uint8_t state = ring->state.load(std::memory_order_acquire);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        if (head == tail){
+            if (state == BinaryLog::retired){
+                ring->state.compare_exchange_strong(state, BinaryLog::reusable, std::memory_order_acq_rel);
+            }
+            continue;
+        }
+
+        /*
+         * Every entry in the ring was recorded after its format was registered: write the
+         * dictionaries not written to this output yet.
+         */
+        if (amount_of_written < BinaryLog::Format::last_id.load(std::memory_order_relaxed)){
+            for (Format* format = BinaryLog::Format::first.load(std::memory_order_acquire) ; format != nullptr ; format = format->next){
+                if (format->id >= formats.size()){
+                    formats.resize(format->id + 1, nullptr);
+                }
+                formats[format->id] = format;
+                if (format->id >= written.size()){
+                    written.resize(format->id + 1, false);
+                }
+                if (written[format->id]){
+                    continue;
+                }
+                beginBlock(block, Block::dictionary);
+                append(block, format->id);
+                append(block, format->amount_of_arguments);
+                block.insert(block.end(), format->codes, format->codes + format->amount_of_arguments);
+                append(block, format->line);
+                block.insert(block.end(), format->file, format->file + strlen(format->file) + 1);
+                block.insert(block.end(), format->format, format->format + strlen(format->format) + 1);
+                endBlock(block, output);
+                written[format->id] = true;
+                amount_of_written++;
+            }
+        }
+
+        /*
+         * The ticks are converted when the dump is written, from the drift since the first open().
+         */
+        if (clocked == false){
+            uint64_t ticks = Trace::now();
+            uint64_t time = monotonicTime();
+            double nanoseconds_per_tick = 1.0;
+#if defined(__x86_64__) || defined(__i386__)
+            nanoseconds_per_tick = (ticks > calibration_ticks && time > calibration_time) ? static_cast<double>(time - calibration_time) / (ticks - calibration_ticks) : 1.0;
+#endif
+            beginBlock(block, Block::clock);
+            append(block, ticks);
+            append(block, time);
+            append(block, nanoseconds_per_tick);
+            endBlock(block, output);
+            clocked = true;
+        }
+
+        beginBlock(block, Block::entries);
+        append(block, ring->base);
+        size_t size = head - tail;
+        size_t offset = tail & (BinaryLog::ring_capacity - 1);
+        size_t first = size < (BinaryLog::ring_capacity - offset) ? size : (BinaryLog::ring_capacity - offset);
+        block.insert(block.end(), ring->data + offset, ring->data + offset + first);
+        block.insert(block.end(), ring->data, ring->data + (size - first));
+
+        /*
+         * The next block of the ring starts from the timestamp of its last entry here.
+         */
+        Reader reader(block.data() + block.size() - size, block.data() + block.size());
+        while (reader.failed == false && reader.cursor < reader.end){
+            uint64_t id = reader.varint();
+            uint64_t delta = reader.varint();
+            if (reader.failed || id >= formats.size() || formats[id] == nullptr || !reader.skipArguments(formats[id]->codes, formats[id]->amount_of_arguments)){
+                break;
+            }
+            ring->base += delta;
+        }
+        endBlock(block, output);
+        ring->tail.store(head, std::memory_order_release);
+    }
+}
+
+namespace {
+    template <typename... ARGUMENTS> void appendFormatted(std::string& text, const std::string& specification, ARGUMENTS... arguments){
+        int length = snprintf(nullptr, 0, specification.c_str(), arguments...);
+        if (length <= 0){
+            return;
+        }
+        size_t position = text.size();
+        text.resize(position + length + 1);
+        snprintf(&text[position], length + 1, specification.c_str(), arguments...);
+        text.resize(position + length);
+    }
+
+    /*
+     * Rebuilds every printf conversion with the length modifier matching the recorded type.
+     *
+     * Returns false when an argument goes past the end of the block.
+     */
+    bool render(std::string& text, const Entry& entry, Reader& reader){
+        const char* format = entry.format.c_str();
+        size_t argument = 0;
+        while (*format != 0){
+            if (*format != '%'){
+                text.push_back(*format++);
+                continue;
+            }
+            if (format[1] == '%'){
+                text.push_back('%');
+                format += 2;
+                continue;
+            }
+            std::string specification(1, *format++);
+            while (*format != 0 && strchr("-+ #0123456789.", *format) != nullptr){
+                specification.push_back(*format++);
+            }
+            while (*format != 0 && strchr("hlLqjzt", *format) != nullptr){
+                format++;
+            }
+            char conversion = *format != 0 ? *format++ : 's';
+            if (argument >= entry.codes.size()){
+                text += specification + conversion;
+                continue;
+            }
+
+            int64_t signed_value = 0;
+            uint64_t unsigned_value = 0;
+            double real_value = 0;
+            std::string string_value;
+            bool is_real = false;
+            bool is_string = false;
+            switch (static_cast<BinaryLog::Type>(entry.codes[argument++])){
+                case BinaryLog::Type::u8: unsigned_value = static_cast<uint8_t>(reader.varint()); signed_value = unsigned_value; break;
+                case BinaryLog::Type::i8: signed_value = static_cast<int8_t>(reader.zigzag()); unsigned_value = signed_value; break;
+                case BinaryLog::Type::u16: unsigned_value = static_cast<uint16_t>(reader.varint()); signed_value = unsigned_value; break;
+                case BinaryLog::Type::i16: signed_value = static_cast<int16_t>(reader.zigzag()); unsigned_value = signed_value; break;
+                case BinaryLog::Type::u32: unsigned_value = static_cast<uint32_t>(reader.varint()); signed_value = unsigned_value; break;
+                case BinaryLog::Type::i32: signed_value = static_cast<int32_t>(reader.zigzag()); unsigned_value = signed_value; break;
+                case BinaryLog::Type::u64: unsigned_value = reader.varint(); signed_value = unsigned_value; break;
+                case BinaryLog::Type::i64: signed_value = reader.zigzag(); unsigned_value = signed_value; break;
+                case BinaryLog::Type::character: signed_value = reader.load<char>(); unsigned_value = signed_value; break;
+                case BinaryLog::Type::pointer: unsigned_value = reader.load<uint64_t>(); signed_value = unsigned_value; break;
+                case BinaryLog::Type::f32: real_value = reader.load<float>(); is_real = true; break;
+                case BinaryLog::Type::f64: real_value = reader.load<double>(); is_real = true; break;
+                case BinaryLog::Type::string: {
+                    const uint8_t* string = reader.skip(reader.load<uint8_t>());
+                    if (string != nullptr){
+                        string_value.assign(reinterpret_cast<const char*>(string), reader.cursor - string);
+                    }
+                    is_string = true;
+                    break;
+                }
+            }
+            if (reader.failed){
+                return false;
+            }
+
+            if (is_string || conversion == 's'){
+                appendFormatted(text, specification + 's', is_string ? string_value.c_str() : "");
+            } else if (strchr("fFeEgGaA", conversion) != nullptr){
+                appendFormatted(text, specification + conversion, is_real ? real_value : static_cast<double>(signed_value));
+            } else if (is_real){
+                appendFormatted(text, specification + 'g', real_value);
+            } else if (conversion == 'c'){
+                appendFormatted(text, specification + 'c', static_cast<int>(signed_value));
+            } else if (conversion == 'p'){
+                appendFormatted(text, specification + 'p', reinterpret_cast<void*>(static_cast<uintptr_t>(unsigned_value)));
+            } else if (conversion == 'd' || conversion == 'i'){
+                appendFormatted(text, specification + "ll" + conversion, static_cast<long long>(signed_value));
+            } else {
+                appendFormatted(text, specification + "ll" + conversion, static_cast<unsigned long long>(unsigned_value));
+            }
+        }
+        return true;
+    }
+}
+
+size_t BinaryLog::decode(const uint8_t* data, size_t size, std::function<void(const char*, size_t)> write){
+    std::unordered_map<uint16_t, Entry> entries;
+    size_t position = 0;
+    if (size >= sizeof(BinaryLog::magic) && memcmp(data, BinaryLog::magic, sizeof(BinaryLog::magic)) == 0){
+        position += sizeof(BinaryLog::magic);
+    }
+    uint64_t clock_ticks = 0;
+    uint64_t clock_time = 0;
+    double nanoseconds_per_tick = 1.0;
+    std::string text;
+    while ((size - position) >= BinaryLog::block_header_size){
+        Reader header(data + position, data + size);
+        Block kind = static_cast<Block>(header.load<uint8_t>());
+        uint32_t body_size = header.load<uint32_t>();
+        if ((size - position - BinaryLog::block_header_size) < body_size){
+            break;
+        }
+        position += BinaryLog::block_header_size + body_size;
+        Reader reader(header.cursor, data + position);
+
+        /*
+         * A dictionary block that does not fit its body is dropped, its entries then decode as
+         * an unknown format.
+         */
+        if (kind == Block::dictionary){
+            Entry entry;
+            uint16_t defined_id = reader.load<uint16_t>();
+            uint8_t amount_of_arguments = reader.load<uint8_t>();
+            const uint8_t* codes = reader.skip(amount_of_arguments);
+            reader.load<uint32_t>();
+            reader.string();
+            const char* format = reader.string();
+            if (reader.failed == false){
+                entry.codes.assign(codes, codes + amount_of_arguments);
+                entry.format = format;
+                entries[defined_id] = entry;
+            }
+        } else if (kind == Block::clock){
+            uint64_t ticks = reader.load<uint64_t>();
+            uint64_t time = reader.load<uint64_t>();
+            double rate = reader.load<double>();
+            if (reader.failed == false && isfinite(rate)){
+                clock_ticks = ticks;
+                clock_time = time;
+                nanoseconds_per_tick = rate;
+            }
+        } else if (kind == Block::entries){
+
+            /*
+             * An entry has no size of its own: after an unknown or invalid one the rest of the
+             * block cannot be found and is skipped.
+             */
+            uint64_t timestamp = reader.load<uint64_t>();
+            while (reader.failed == false && reader.cursor < reader.end){
+                uint64_t id = reader.varint();
+                timestamp += reader.varint();
+                if (reader.failed){
+                    break;
+                }
+                int64_t time = static_cast<int64_t>(clock_time) + llround(static_cast<int64_t>(timestamp - clock_ticks) * nanoseconds_per_tick);
+                time = time < 0 ? 0 : time;
+                text.clear();
+                appendFormatted(text, "[%llu.%09llu] ", static_cast<unsigned long long>(time / 1000000000), static_cast<unsigned long long>(time % 1000000000));
+                auto entry = entries.find(static_cast<uint16_t>(id));
+                if (id > UINT16_MAX || entry == entries.end()){
+                    appendFormatted(text, "<unknown format %llu>\r\n", static_cast<unsigned long long>(id));
+                    write(text.data(), text.size());
+                    break;
+                }
+                if (render(text, entry->second, reader) == false){
+                    appendFormatted(text, "<invalid entry of format %u>\r\n", static_cast<unsigned>(id));
+                    write(text.data(), text.size());
+                    break;
+                }
+                write(text.data(), text.size());
+            }
+        }
+    }
+    return position;
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+
+#include "./Sink.h"
+#include "./Trace.h"
+
+/**
+ * @brief Record a deferred log entry: only the format id, a timestamp delta and the raw arguments are written.
+ *
+ * The format must be a string literal using printf conversions. The argument layout is taken
+ * from the argument types at compile time; char pointers are copied as strings.
+ */
+#define BINARY_LOG(format, ...) [](const auto&... arguments){ \
+        static const System::BinaryLog::Format _binary_log_format(format, __FILE__, __LINE__, System::BinaryLog::Signature<std::decay_t<decltype(arguments)>...>::codes, sizeof...(arguments)); \
+        System::BinaryLog::record(_binary_log_format, arguments...); \
+    }(__VA_ARGS__)
+
+namespace System{
+
+    /**
+     * @class BinaryLog
+     *
+     * @brief Deferred binary logging into a Sink, decoded offline by BinaryLog::decode.
+     *
+     * Every thread records into its own ring of ring_capacity bytes, as System::Trace does, so an
+     * entry costs a time stamp counter read and a few stores without any shared write. An entry is
+     * the format id and the ticks since the previous entry of its thread, both as variable length
+     * integers, followed by the arguments; integers are variable length too. A ring that is full
+     * drops the new entries and counts them.
+     *
+     * A drain thread started by open() moves the rings into the sink every flush interval, and as
+     * soon as a ring is half full. The stream starts with a magic header, then holds blocks: the
+     * dictionary of every format (id, argument types, file, line and format string), a clock
+     * block converting ticks to nanoseconds, measured when the block is written, and the entries
+     * of one ring, which start from the absolute timestamp of the entry before them.
+     */
+    class BinaryLog{
+    public:
+        enum class Type : uint8_t {
+            u8, i8, u16, i16, u32, i32, u64, i64,
+            f32, f64, character, pointer, string,
+        };
+
+        /**
+         * @brief Kinds of blocks, each one written as a uint8_t kind and a uint32_t body size.
+         */
+        enum class Block : uint8_t {
+            dictionary,     ///< uint16_t id, uint8_t amount of arguments, their types, uint32_t line, file and format strings
+            clock,          ///< uint64_t ticks, uint64_t nanoseconds at those ticks, double nanoseconds per tick
+            entries,        ///< uint64_t ticks of the entry before them, then the entries of a ring
+        };
+
+        static constexpr char magic[8] = {'W', 'R', 'Z', 'B', 'L', 'O', 'G', '2'};
+        static constexpr size_t block_header_size = 5;
+        static constexpr size_t ring_capacity = 1 << 20;       ///< Bytes kept per thread until the drain, a power of two
+        static constexpr size_t max_string_size = 255;          ///< Longer strings are truncated
+        static constexpr size_t max_header_size = 3 + 10;       ///< Variable length uint16_t id and uint64_t delta
+
+        template <typename DATA_TYPE, typename = void> struct Argument;
+
+        template <typename... ARGUMENTS> struct Signature{
+            static constexpr uint8_t codes[sizeof...(ARGUMENTS) + 1] = {static_cast<uint8_t>(Argument<ARGUMENTS>::type)..., 0};
+            static constexpr size_t max_size = (0 + ... + Argument<ARGUMENTS>::max_size);
+        };
+
+        /**
+         * @class Format
+         *
+         * @brief Call site description, registered once per BINARY_LOG expansion.
+         */
+        class Format{
+            friend class BinaryLog;
+        private:
+            static std::atomic<Format*> first;
+            static std::atomic<uint16_t> last_id;
+            Format* next {nullptr};
+        public:
+            const uint16_t id;
+            const char* const format;
+            const char* const file;
+            const uint32_t line;
+            const uint8_t* const codes;
+            const uint8_t amount_of_arguments;
+            Format(const char* format, const char* file, uint32_t line, const uint8_t* codes, uint8_t amount_of_arguments);
+        };
+
+        /**
+         * @brief Start draining the entries into output, beginning with the magic header.
+         *
+         * open() and close() are called from one thread at a time.
+         *
+         * @param output The sink receiving the dump.
+         * @param flush_interval Longest time in nanoseconds an entry waits in its ring.
+         *
+         * @return False when output may cut records (an AsyncOutput with OverflowPolicy::overwrite),
+         * since the dump could not be decoded.
+         */
+        static bool open(Sink& output, uint64_t flush_interval = 10000000);
+
+        /**
+         * @brief Stop recording, drain the rings a last time and flush output.
+         */
+        static void close(void);
+
+        /**
+         * @brief Drain the entries recorded so far and flush output.
+         */
+        static void flush(void);
+
+        /**
+         * @brief Amount of entries dropped because the ring of their thread was full.
+         */
+        static uint64_t getDropped(void);
+
+        template <typename... ARGUMENTS> static inline void record(const Format& format, const ARGUMENTS&... arguments){
+            if (BinaryLog::output.load(std::memory_order_acquire) == nullptr){
+                return;
+            }
+            Ring* ring = BinaryLog::local_ring;
+            if (ring == nullptr){
+                ring = BinaryLog::acquire();
+            }
+            uint64_t timestamp = Trace::now();
+            constexpr size_t max_size = BinaryLog::max_header_size + Signature<ARGUMENTS...>::max_size;
+            uint64_t head = ring->head.load(std::memory_order_relaxed);
+            size_t offset = head & (BinaryLog::ring_capacity - 1);
+
+            /*
+             * The entry is encoded in place when the ring has max_size contiguous free bytes,
+             * which is nearly always, otherwise in buffer and copied around the end of the ring.
+             */
+            uint8_t buffer[max_size];
+            bool in_place = (offset + max_size <= BinaryLog::ring_capacity) && (head + max_size - ring->cached_tail <= BinaryLog::ring_capacity);
+            uint8_t* begin = in_place ? ring->data + offset : buffer;
+            uint8_t* cursor = begin;
+            BinaryLog::writeVarint(cursor, format.id);
+            BinaryLog::writeVarint(cursor, timestamp - ring->last_timestamp);
+            (Argument<ARGUMENTS>::write(cursor, arguments), ...);
+            size_t size = cursor - begin;
+            if (in_place == false && BinaryLog::copy(*ring, head, buffer, size) == false){
+                return;
+            }
+            ring->last_timestamp = timestamp;
+            ring->head.store(head + size, std::memory_order_release);
+
+            /*
+             * Only the entry crossing half of the ring wakes the drain, once per half ring.
+             */
+            if (((head - ring->cached_tail) < (BinaryLog::ring_capacity >> 1)) && ((head + size - ring->cached_tail) >= (BinaryLog::ring_capacity >> 1))) [[unlikely]] {
+                BinaryLog::wake();
+            }
+        }
+
+        /**
+         * @brief Turn a dump back into text, one line prefix "[seconds.nanoseconds] " per entry.
+         *
+         * @param data The dump.
+         * @param size Size of the dump in bytes.
+         * @param write Receives the text.
+         *
+         * @return The amount of bytes decoded, less than size when the dump ends in the middle of a block.
+         */
+        static size_t decode(const uint8_t* data, size_t size, std::function<void(const char*, size_t)> write);
+
+        static inline void writeVarint(uint8_t*& cursor, uint64_t value){
+            while (value >= 0x80){
+                *cursor++ = static_cast<uint8_t>(value) | 0x80;
+                value >>= 7;
+            }
+            *cursor++ = static_cast<uint8_t>(value);
+        }
+    private:
+        static constexpr uint8_t owned = 0;         ///< Its thread records into it
+        static constexpr uint8_t retired = 1;       ///< Its thread exited, the drain has not emptied it yet
+        static constexpr uint8_t reusable = 2;      ///< Its thread exited and it was emptied
+
+        /*
+         * Single producer ring: its thread writes head, the drain writes tail, each on its own
+         * cache line. Timestamps keep counting across owners, so a reused ring needs no reset.
+         */
+        struct Ring{
+            Ring* next {nullptr};
+            std::atomic<uint8_t> state {BinaryLog::owned};
+            std::atomic<uint64_t> head {0};
+            std::atomic<uint64_t> dropped {0};
+            uint64_t cached_tail {0};
+            uint64_t last_timestamp {0};
+            alignas(64) std::atomic<uint64_t> tail {0};
+            uint64_t base {0};                      ///< Timestamp of the last drained entry, used by the drain only
+            alignas(64) uint8_t data[BinaryLog::ring_capacity];
+        };
+
+        /*
+         * Retires the ring of its thread when the thread exits.
+         */
+        struct Owner{
+            Ring* ring {nullptr};
+            ~Owner(void);
+        };
+
+        static std::atomic<Sink*> output;
+        static std::atomic<Ring*> first;
+        static inline thread_local Ring* local_ring {nullptr};
+        static thread_local Owner owner;
+        static Ring* acquire(void);
+
+        /*
+         * Copy an entry that did not fit in place, or count it as dropped when the ring is full.
+         */
+        [[gnu::cold, gnu::noinline]] static bool copy(Ring& ring, uint64_t head, const uint8_t* entry, size_t size);
+        [[gnu::cold, gnu::noinline]] static void wake(void);
+        static void drain(Sink& output);
+    };
+
+    /*
+     * Integers are written as variable length integers, zigzag encoded when signed, so small
+     * values take one byte whatever their type.
+     */
+    template <typename DATA_TYPE> struct BinaryLog::Argument<DATA_TYPE, std::enable_if_t<std::is_integral<DATA_TYPE>::value || std::is_enum<DATA_TYPE>::value>>{
+        using Integer = typename std::conditional_t<std::is_enum<DATA_TYPE>::value, std::underlying_type<DATA_TYPE>, std::enable_if<true, DATA_TYPE>>::type;
+        static constexpr Type type =
+            std::is_same<DATA_TYPE, char>::value ? Type::character :
+            sizeof(DATA_TYPE) == 1 ? (std::is_signed<Integer>::value ? Type::i8 : Type::u8) :
+            sizeof(DATA_TYPE) == 2 ? (std::is_signed<Integer>::value ? Type::i16 : Type::u16) :
+            sizeof(DATA_TYPE) == 4 ? (std::is_signed<Integer>::value ? Type::i32 : Type::u32) :
+            (std::is_signed<Integer>::value ? Type::i64 : Type::u64);
+        static constexpr size_t max_size = type == Type::character ? 1 : (sizeof(DATA_TYPE) * 8 + 6) / 7;
+        static inline void write(uint8_t*& cursor, const DATA_TYPE& value){
+            Integer integer = static_cast<Integer>(value);
+            if constexpr (type == Type::character){
+                memcpy(cursor++, &value, 1);
+            } else if constexpr (std::is_signed<Integer>::value){
+                int64_t extended = integer;
+                BinaryLog::writeVarint(cursor, (static_cast<uint64_t>(extended) << 1) ^ static_cast<uint64_t>(extended >> 63));
+            } else {
+                BinaryLog::writeVarint(cursor, static_cast<uint64_t>(integer));
+            }
+        }
+    };
+
+    template <typename DATA_TYPE> struct BinaryLog::Argument<DATA_TYPE, std::enable_if_t<std::is_floating_point<DATA_TYPE>::value>>{
+        static constexpr Type type = sizeof(DATA_TYPE) == 4 ? Type::f32 : Type::f64;
+        static constexpr size_t max_size = sizeof(DATA_TYPE) == 4 ? 4 : 8;
+        static inline void write(uint8_t*& cursor, const DATA_TYPE& value){
+            if constexpr (sizeof(DATA_TYPE) == 4){
+                memcpy(cursor, &value, 4);
+            } else {
+                double converted = static_cast<double>(value);
+                memcpy(cursor, &converted, 8);
+            }
+            cursor += max_size;
+        }
+    };
+
+    template <typename DATA_TYPE> struct BinaryLog::Argument<DATA_TYPE, std::enable_if_t<std::is_pointer<DATA_TYPE>::value>>{
+        static constexpr bool is_string = std::is_same<std::remove_cv_t<std::remove_pointer_t<DATA_TYPE>>, char>::value;
+        static constexpr Type type = is_string ? Type::string : Type::pointer;
+        static constexpr size_t max_size = is_string ? (1 + BinaryLog::max_string_size) : sizeof(uint64_t);
+        static inline void write(uint8_t*& cursor, const DATA_TYPE& value){
+            if constexpr (is_string){
+                size_t length = value == nullptr ? 0 : strnlen(value, BinaryLog::max_string_size);
+                *cursor++ = static_cast<uint8_t>(length);
+                memcpy(cursor, value, length);
+                cursor += length;
+            } else {
+                uint64_t address = reinterpret_cast<uintptr_t>(value);
+                memcpy(cursor, &address, sizeof(uint64_t));
+                cursor += sizeof(uint64_t);
+            }
+        }
+    };
+
+    template <size_t SIZE> struct BinaryLog::Argument<char[SIZE]> : BinaryLog::Argument<const char*>{
+        static inline void write(uint8_t*& cursor, const char (&value)[SIZE]){
+            BinaryLog::Argument<const char*>::write(cursor, value);
+        }
+    };
+}
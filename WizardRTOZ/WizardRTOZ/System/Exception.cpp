@@ -2,12 +2,21 @@
 
 using namespace System;
 
-const Exception Exceptions::logic_error("logic_error");
-const Exception Exceptions::domain_error("domain_error");
-const Exception Exceptions::invalid_argument("invalid_argument");
-const Exception Exceptions::length_error("length_error");
-const Exception Exceptions::out_of_range("out_of_range");
-const Exception Exceptions::runtime_error("runtime_error");
-const Exception Exceptions::range_error("range_error");
-const Exception Exceptions::overflow_error("overflow_error");
-const Exception Exceptions::underflow_error("underflow_error");
+const Exception Exceptions::logic_error("logic_error", Status::logic_error);
+const Exception Exceptions::domain_error("domain_error", Status::domain_error);
+const Exception Exceptions::invalid_argument("invalid_argument", Status::invalid_argument);
+const Exception Exceptions::length_error("length_error", Status::length_error);
+const Exception Exceptions::out_of_range("out_of_range", Status::out_of_range);
+const Exception Exceptions::runtime_error("runtime_error", Status::runtime_error);
+const Exception Exceptions::range_error("range_error", Status::range_error);
+const Exception Exceptions::overflow_error("overflow_error", Status::overflow_error);
+const Exception Exceptions::underflow_error("underflow_error", Status::underflow_error);
+
+bool Exception::raise(const char* message, FunctionReference<bool(const Exception&)> treatment_callback) const {
+    this->warning(message);
+    if constexpr (check_policy == CheckPolicy::assert_only){
+        IOStream::flush();
+        abort();
+    }
+    return treatment_callback ? treatment_callback(*this) : false;
+}
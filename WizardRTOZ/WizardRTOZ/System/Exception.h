@@ -1,18 +1,46 @@
 #pragma once
 
-#include <functional>
 #include <stdlib.h>
 #include <stdint.h>
+#include "./FunctionReference.h"
 #include "./IOStream.h"
+#include "./Status.h"
+
+/*
+ * Build with -DSYSTEM_CHECK_POLICY=assert_only or -DSYSTEM_CHECK_POLICY=none to trade the
+ * System::Exceptions checks for speed.
+ */
+#ifndef SYSTEM_CHECK_POLICY
+#define SYSTEM_CHECK_POLICY full
+#endif
 
 namespace System{
 
+    /**
+     * @enum CheckPolicy
+     *
+     * @brief What Exception::test does, selected at compile time through SYSTEM_CHECK_POLICY.
+     */
+    enum class CheckPolicy : uint8_t {
+        full,           ///< Failed checks print a warning and run the treatment callback
+        assert_only,    ///< Failed checks print a warning and abort
+        none,           ///< Checks are compiled out
+    };
+
+    constexpr CheckPolicy check_policy = CheckPolicy::SYSTEM_CHECK_POLICY;
+
     class Exception{
     private:
         const uint64_t id;
         const char* name;
+        const Status status;
+
+        /*
+         * Kept out of line, so a check costs a compare and a never taken branch in the caller.
+         */
+        [[gnu::cold, gnu::noinline]] bool raise(const char* message, FunctionReference<bool(const Exception&)> treatment_callback) const;
     public:
-        inline Exception(const char* name) : id(reinterpret_cast<uint64_t>(this)), name(name) {}
+        inline Exception(const char* name, Status status = Status::runtime_error) : id(reinterpret_cast<uint64_t>(this)), name(name), status(status) {}
         inline void warning(const char* message = nullptr) const {
             if (message == nullptr){
                 IOStream::printf("[!] Exception %s\r\n", this->name);
@@ -24,12 +52,55 @@ namespace System{
             this->warning(message);
             exit(-1);
         }
-        inline bool test(bool condition, const char* message = nullptr, std::function<bool(Exception)> treatment_callback = [](Exception){ return false; }) const {
-            if (condition == false){
+
+        /**
+         * @brief Raise the exception when condition is true, according to check_policy.
+         *
+         * @return True when condition is false, otherwise the result of treatment_callback (false without one).
+         */
+        inline bool test(bool condition, const char* message = nullptr, FunctionReference<bool(const Exception&)> treatment_callback = nullptr) const {
+            if constexpr (check_policy == CheckPolicy::none){
+                (void) condition;
+                (void) message;
+                (void) treatment_callback;
+                return true;
+            } else {
+                if (condition) [[unlikely]] {
+                    return this->raise(message, treatment_callback);
+                }
                 return true;
             }
-            this->warning(message);
-            return treatment_callback(*this);
+        }
+
+        /**
+         * @brief Report a runtime condition callers branch on, such as a full container or a failed
+         * system call.
+         *
+         * Unlike test, condition is evaluated under every check_policy and never aborts:
+         * CheckPolicy::none only silences the warning.
+         *
+         * @return True when condition is false.
+         */
+        inline bool guard(bool condition, const char* message = nullptr) const {
+            if (condition) [[unlikely]] {
+                if constexpr (check_policy != CheckPolicy::none){
+                    this->warning(message);
+                }
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Unchecked counterpart of test: nothing is printed, the matching status is returned instead.
+         *
+         * @return Status::ok when condition is false.
+         */
+        inline Status check(bool condition) const {
+            return condition ? this->status : Status::ok;
+        }
+        inline Status getStatus(void) const {
+            return this->status;
         }
         inline bool operator==(const Exception& exception) const {
             return (this->id == exception.id);
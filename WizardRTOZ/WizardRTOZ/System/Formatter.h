@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <charconv>
+#include <type_traits>
+
+namespace System{
+
+    /**
+     * @struct FormatOptions
+     *
+     * @brief How Formatter turns a value into text.
+     */
+    struct FormatOptions{
+        uint8_t base {10};          ///< 2, 8, 10 or 16. Integers only.
+        uint8_t width {0};          ///< Minimum amount of characters, padded on the left with fill
+        int8_t precision {2};       ///< Digits after the decimal point, -1 for the shortest exact representation. Floating points only.
+        char fill {' '};
+    };
+
+    /*
+     * Manipulators, used as stream << System::hex << System::width(8) << value.
+     */
+    struct FormatBase{ uint8_t value; };
+    struct FormatWidth{ uint8_t value; };
+    struct FormatPrecision{ int8_t value; };
+    struct FormatFill{ char value; };
+
+    constexpr FormatBase bin {2};
+    constexpr FormatBase oct {8};
+    constexpr FormatBase dec {10};
+    constexpr FormatBase hex {16};
+    constexpr FormatWidth width(uint8_t value){ return FormatWidth{value}; }
+    constexpr FormatPrecision precision(int8_t value){ return FormatPrecision{value}; }
+    constexpr FormatFill fill(char value){ return FormatFill{value}; }
+
+    /**
+     * @class Formatter
+     *
+     * @brief Allocation-free conversion of integers, floating points and pointers to text.
+     *
+     * The conversion is picked at compile time from the value type and done by std::to_chars,
+     * so no format string is parsed and no locale is involved.
+     */
+    class Formatter{
+    public:
+        static constexpr size_t max_size = 72;     ///< Largest text written by format, width included
+        static constexpr int8_t max_precision = Formatter::max_size - 10;  ///< Larger precisions are clamped, so the scientific notation fits
+
+        /**
+         * @brief Write value as text in buffer, which must hold max_size characters.
+         *
+         * Negative integers in a base other than 10 are written as their two's complement, like printf.
+         * Floating points too large for max_size are written in scientific notation, with at most
+         * max_precision digits after the decimal point.
+         *
+         * @return The amount of characters written.
+         */
+        template <typename DATA_TYPE> static inline size_t format(char* buffer, DATA_TYPE value, const FormatOptions& options = FormatOptions()){
+            static_assert(std::is_arithmetic<DATA_TYPE>::value || std::is_pointer<DATA_TYPE>::value, "Only arithmetic types and pointers are formatted.");
+            char* end = buffer + Formatter::max_size;
+            char* last = buffer;
+            if constexpr (std::is_same<DATA_TYPE, bool>::value){
+                last = Formatter::copy(buffer, value ? "true" : "false");
+            } else if constexpr (std::is_pointer<DATA_TYPE>::value){
+                buffer[0] = '0';
+                buffer[1] = 'x';
+                last = std::to_chars(buffer + 2, end, reinterpret_cast<uintptr_t>(value), 16).ptr;
+            } else if constexpr (std::is_integral<DATA_TYPE>::value){
+                if (options.base == 10){
+                    last = std::to_chars(buffer, end, value).ptr;
+                } else {
+                    last = std::to_chars(buffer, end, static_cast<std::make_unsigned_t<DATA_TYPE>>(value), options.base).ptr;
+                }
+            } else {
+                int precision = options.precision < Formatter::max_precision ? options.precision : Formatter::max_precision;
+                std::to_chars_result result = precision < 0 ?
+                    std::to_chars(buffer, end, value, std::chars_format::fixed) :
+                    std::to_chars(buffer, end, value, std::chars_format::fixed, precision);
+                if (result.ec != std::errc()){
+                    result = precision < 0 ?
+                        std::to_chars(buffer, end, value, std::chars_format::scientific) :
+                        std::to_chars(buffer, end, value, std::chars_format::scientific, precision);
+                }
+                last = result.ec == std::errc() ? result.ptr : buffer;
+            }
+            size_t sign = std::is_pointer<DATA_TYPE>::value ? 2 : ((last != buffer && buffer[0] == '-') ? 1 : 0);
+            return Formatter::pad(buffer, last - buffer, sign, options);
+        }
+    private:
+        static inline char* copy(char* buffer, const char* text){
+            size_t size = strlen(text);
+            memcpy(buffer, text, size);
+            return buffer + size;
+        }
+
+        /*
+         * Right aligns the size characters at the start of buffer. The first sign characters, a minus
+         * or the "0x" of a pointer, stay in front of zeros.
+         */
+        static inline size_t pad(char* buffer, size_t size, size_t sign, const FormatOptions& options){
+            size_t width = options.width < Formatter::max_size ? options.width : Formatter::max_size;
+            if (size >= width){
+                return size;
+            }
+            size_t padding = width - size;
+            sign = options.fill == '0' ? sign : 0;
+            memmove(buffer + sign + padding, buffer + sign, size - sign);
+            memset(buffer + sign, options.fill, padding);
+            return width;
+        }
+    };
+}
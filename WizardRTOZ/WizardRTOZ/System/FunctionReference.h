@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace System{
+
+    template <typename SIGNATURE> class FunctionReference;
+
+    /**
+     * @class FunctionReference
+     *
+     * @brief Non-owning reference to a callable, two pointers wide.
+     *
+     * Unlike std::function nothing is allocated or copied, so the referenced callable must outlive
+     * the FunctionReference. It is meant for callback arguments, where temporaries live long enough.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS>
+    class FunctionReference<RETURN_TYPE(ARGUMENTS...)>{
+    private:
+        void* object {nullptr};
+        RETURN_TYPE (*callback)(void*, ARGUMENTS...) {nullptr};
+    public:
+        inline FunctionReference(std::nullptr_t = nullptr) {}
+        template <typename CALLABLE, typename = std::enable_if_t<!std::is_same<std::decay_t<CALLABLE>, FunctionReference>::value>>
+        inline FunctionReference(CALLABLE&& callable)
+            : object(const_cast<void*>(static_cast<const void*>(std::addressof(callable)))),
+              callback([](void* object, ARGUMENTS... arguments) -> RETURN_TYPE {
+                  return (*static_cast<std::remove_reference_t<CALLABLE>*>(object))(std::forward<ARGUMENTS>(arguments)...);
+              }) {}
+        inline explicit operator bool() const {
+            return (this->callback != nullptr);
+        }
+        inline RETURN_TYPE operator()(ARGUMENTS... arguments) const {
+            return this->callback(this->object, std::forward<ARGUMENTS>(arguments)...);
+        }
+    };
+}
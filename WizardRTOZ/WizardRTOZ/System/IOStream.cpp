@@ -2,4 +2,12 @@
 
 using namespace System;
 
-IOStream printer;
+Sink* IOStream::sink = nullptr;
+
+IOStream IOStream::printer;
+IOStream System::printer;
+
+Sink& IOStream::getStandardOutput(void){
+    static StreamSink standard_output(stdout);
+    return standard_output;
+}
@@ -5,33 +5,90 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "./Formatter.h"
+#include "./Sink.h"
+#include "./Trace.h"
+
 namespace System{
 
     class IOStream{
+    private:
+        static constexpr size_t printf_buffer_size = 256;
+        static Sink* sink;
+        FormatOptions options;
     public:
         static IOStream printer;
 
+        /**
+         * @brief Sink writing to the standard output through the stdout buffer, used while no other
+         * sink is attached.
+         */
+        static Sink& getStandardOutput(void);
+
+        static inline Sink& getSink(void){
+            return IOStream::sink != nullptr ? *IOStream::sink : IOStream::getStandardOutput();
+        }
+
+        /**
+         * @brief Send every following write to sink, for example a buffered AsyncOutput.
+         */
+        static inline void attach(Sink& sink){
+            fflush(stdout);
+            IOStream::sink = &sink;
+        }
+
+        /**
+         * @brief Flush the attached sink and go back to writing straight to the standard output.
+         */
+        static inline void detach(void){
+            if (IOStream::sink != nullptr){
+                IOStream::sink->flush();
+                IOStream::sink = nullptr;
+            }
+        }
+        static inline void flush(void){
+            TRACE_ZONE("IOStream::flush");
+            IOStream::getSink().flush();
+        }
         static inline void put(char data){
-            fputc(data, stdout);
+            IOStream::getSink().write(&data, 1);
         }
         static inline void write(const char* message, size_t message_size = 0){
             if (message_size == 0){
-                for (size_t index = 0 ; message[index] != 0 ; index++){
-                    IOStream::put(message[index]);
-                }
-            } else {
-                for (size_t index = 0 ; index < message_size ; index++){
-                    IOStream::put(message[index]);
-                }
+                message_size = strlen(message);
             }
+            IOStream::getSink().write(message, message_size);
+        }
+
+        /**
+         * @brief Write the fragments as one message, without concatenating them.
+         */
+        static inline void write(const struct iovec* fragments, size_t amount_of_fragments){
+            IOStream::getSink().write(fragments, amount_of_fragments);
         }
         static void printf(const char* message, ...) __attribute__((format(printf, 1, 2))){
-            char buffer[100] = {0};
+            char buffer[IOStream::printf_buffer_size];
             va_list arguments;
             va_start(arguments, message);
-            vsnprintf(buffer, 100, message, arguments);
-            IOStream::write(buffer);
+            int length = vsnprintf(buffer, IOStream::printf_buffer_size, message, arguments);
             va_end(arguments);
+            if (length < 0){
+                return;
+            }
+            if (static_cast<size_t>(length) < IOStream::printf_buffer_size){
+                IOStream::write(buffer, length);
+                return;
+            }
+
+            /*
+             * Long messages are formatted again in a buffer of their size instead of being truncated.
+             */
+            char* long_buffer = new char[length + 1];
+            va_start(arguments, message);
+            vsnprintf(long_buffer, length + 1, message, arguments);
+            va_end(arguments);
+            IOStream::write(long_buffer, length);
+            delete[] long_buffer;
         }
         inline IOStream& operator<<(const char* message) {
             IOStream::write(message);
@@ -41,16 +98,36 @@ namespace System{
             IOStream::put(data);
             return *this;
         }
-        inline IOStream& operator<<(float data) {
-            IOStream::printf("%.2f", data);
+        inline IOStream& operator<<(FormatBase base) {
+            this->options.base = base.value;
             return *this;
         }
-        inline IOStream& operator<<(int data) {
-            IOStream::printf("%d", data);
+        inline IOStream& operator<<(FormatWidth width) {
+            this->options.width = width.value;
             return *this;
         }
-        inline IOStream& operator<<(size_t data) {
-            IOStream::printf("%d", static_cast<int>(data));
+        inline IOStream& operator<<(FormatPrecision precision) {
+            this->options.precision = precision.value;
+            return *this;
+        }
+        inline IOStream& operator<<(FormatFill fill) {
+            this->options.fill = fill.value;
+            return *this;
+        }
+
+        /**
+         * @brief Write an integer, floating point or pointer with the current options.
+         *
+         * The width applies to the next value only, like std::ostream.
+         */
+        template <typename DATA_TYPE, typename = std::enable_if_t<
+            (std::is_arithmetic<DATA_TYPE>::value && !std::is_same<DATA_TYPE, char>::value) ||
+            (std::is_pointer<DATA_TYPE>::value && !std::is_same<std::remove_cv_t<std::remove_pointer_t<DATA_TYPE>>, char>::value)
+        >>
+        inline IOStream& operator<<(DATA_TYPE data) {
+            char buffer[Formatter::max_size];
+            IOStream::write(buffer, Formatter::format(buffer, data, this->options));
+            this->options.width = 0;
             return *this;
         }
     };
@@ -0,0 +1,92 @@
+#include "./Sink.h"
+#include "./Exception.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace System;
+
+bool FileSink::write(const struct iovec* fragments, size_t amount_of_fragments){
+    size_t offset = 0;
+    while (amount_of_fragments > 0){
+        struct iovec vectors[FileSink::max_fragments];
+        size_t amount_of_vectors = amount_of_fragments < FileSink::max_fragments ? amount_of_fragments : FileSink::max_fragments;
+        for (size_t index = 0 ; index < amount_of_vectors ; index++){
+            vectors[index] = fragments[index];
+        }
+        vectors[0].iov_base = static_cast<char*>(vectors[0].iov_base) + offset;
+        vectors[0].iov_len -= offset;
+
+        ssize_t written = writev(this->file_descriptor, vectors, amount_of_vectors);
+        if (written < 0){
+            if (errno == EINTR){
+                continue;
+            }
+            return false;
+        }
+
+        /*
+         * Skip the fragments written completely; offset is what was written of the next one.
+         */
+        size_t position = offset + written;
+        while (amount_of_fragments > 0 && position >= fragments->iov_len){
+            position -= fragments->iov_len;
+            fragments++;
+            amount_of_fragments--;
+        }
+        offset = position;
+    }
+    return true;
+}
+
+bool StreamSink::write(const struct iovec* fragments, size_t amount_of_fragments){
+    bool complete = true;
+    flockfile(this->stream);
+    for (size_t index = 0 ; index < amount_of_fragments ; index++){
+        size_t size = fragments[index].iov_len;
+        complete = complete && fwrite_unlocked(fragments[index].iov_base, 1, size, this->stream) == size;
+    }
+    funlockfile(this->stream);
+    return complete;
+}
+
+MemorySink::MemorySink(const char* name) : FileSink(memfd_create(name, MFD_CLOEXEC)) {
+    System::Exceptions::runtime_error.guard(this->file_descriptor < 0, "Could not create the memory file.");
+}
+
+MemorySink::~MemorySink(void){
+    if (this->file_descriptor >= 0){
+        close(this->file_descriptor);
+    }
+}
+
+size_t MemorySink::getSize(void) const {
+    struct stat status;
+    if (fstat(this->file_descriptor, &status) != 0){
+        return 0;
+    }
+    return status.st_size;
+}
+
+size_t MemorySink::read(char* buffer, size_t size, size_t offset) const {
+    size_t copied = 0;
+    while (copied < size){
+        ssize_t result = pread(this->file_descriptor, buffer + copied, size - copied, offset + copied);
+        if (result < 0 && errno == EINTR){
+            continue;
+        }
+        if (result <= 0){
+            break;
+        }
+        copied += result;
+    }
+    return copied;
+}
+
+void MemorySink::clear(void){
+    if (ftruncate(this->file_descriptor, 0) == 0){
+        lseek(this->file_descriptor, 0, SEEK_SET);
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/uio.h>
+
+namespace System{
+
+    /**
+     * @class Sink
+     *
+     * @brief Destination of IOStream, UnitTest and AsyncOutput bytes.
+     *
+     * Sinks receive whole buffers. A message made of several fragments is passed as an array of
+     * iovec, so it reaches the destination in one call without being concatenated first.
+     */
+    class Sink{
+    public:
+        virtual ~Sink(void) = default;
+
+        /**
+         * @brief Write the fragments, in order, as one message.
+         *
+         * @return False when (part of) the message was lost.
+         */
+        virtual bool write(const struct iovec* fragments, size_t amount_of_fragments) = 0;
+
+        /**
+         * @brief Wait until every byte written before the call reached the destination.
+         */
+        virtual void flush(void){}
+
+        /**
+         * @brief False when the sink may keep only part of a message, so a stream of records
+         * written to it cannot be parsed again.
+         */
+        virtual bool preservesMessages(void) const {
+            return true;
+        }
+
+        inline bool write(const char* message, size_t size){
+            struct iovec fragment = {const_cast<char*>(message), size};
+            return this->write(&fragment, 1);
+        }
+    };
+
+    /**
+     * @class FileSink
+     *
+     * @brief Sink writing to a file descriptor with writev(2), retrying partial writes.
+     *
+     * The file descriptor is not owned.
+     */
+    class FileSink : public Sink{
+    private:
+        static constexpr size_t max_fragments = 16;    ///< Fragments handed to one writev(2)
+    protected:
+        int file_descriptor;
+    public:
+        inline FileSink(int file_descriptor) : file_descriptor(file_descriptor) {}
+        using Sink::write;
+        bool write(const struct iovec* fragments, size_t amount_of_fragments) override;
+        inline int getFileDescriptor(void) const {
+            return this->file_descriptor;
+        }
+    };
+
+    /**
+     * @class StreamSink
+     *
+     * @brief Sink writing through a C stdio stream, so small writes share its buffer and stay in
+     * order with printf and puts on the same stream.
+     *
+     * The fragments of a message are written under the stream lock. The stream is not owned.
+     */
+    class StreamSink : public Sink{
+    private:
+        FILE* stream;
+    public:
+        inline StreamSink(FILE* stream) : stream(stream) {}
+        using Sink::write;
+        bool write(const struct iovec* fragments, size_t amount_of_fragments) override;
+        inline void flush(void) override {
+            fflush(this->stream);
+        }
+    };
+
+    /**
+     * @class MemorySink
+     *
+     * @brief Sink writing to an anonymous in-memory file (memfd_create(2)).
+     *
+     * The content can be read back, mapped, or handed to another process through the file descriptor.
+     * When the file cannot be created, runtime_error is raised and every write fails.
+     */
+    class MemorySink : public FileSink{
+    public:
+        MemorySink(const char* name = "WizardRTOZ");
+        ~MemorySink(void);
+        MemorySink(const MemorySink&) = delete;
+        MemorySink& operator=(const MemorySink&) = delete;
+
+        /**
+         * @brief Amount of bytes written so far.
+         */
+        size_t getSize(void) const;
+
+        /**
+         * @brief Copy up to size bytes starting at offset into buffer.
+         *
+         * @return The amount of bytes copied.
+         */
+        size_t read(char* buffer, size_t size, size_t offset = 0) const;
+
+        /**
+         * @brief Discard the content.
+         */
+        void clear(void);
+    };
+
+    /**
+     * @class TeeSink
+     *
+     * @brief Sink duplicating every message into two sinks.
+     */
+    class TeeSink : public Sink{
+    private:
+        Sink& first;
+        Sink& second;
+    public:
+        inline TeeSink(Sink& first, Sink& second) : first(first), second(second) {}
+        using Sink::write;
+        inline bool write(const struct iovec* fragments, size_t amount_of_fragments) override {
+            bool first_complete = this->first.write(fragments, amount_of_fragments);
+            bool second_complete = this->second.write(fragments, amount_of_fragments);
+            return first_complete && second_complete;
+        }
+        inline void flush(void) override {
+            this->first.flush();
+            this->second.flush();
+        }
+        inline bool preservesMessages(void) const override {
+            return this->first.preservesMessages() && this->second.preservesMessages();
+        }
+    };
+}
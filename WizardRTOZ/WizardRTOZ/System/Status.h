@@ -13,7 +13,7 @@ namespace System {
      * @brief Enum class representing different status codes.
      */
     enum class Status : int8_t {
-        logic_error,        ///< Logic error status
+        logic_error = 1,    ///< Logic error status
         domain_error,       ///< Domain error status
         invalid_argument,   ///< Invalid argument error status
         length_error,       ///< Length error status
@@ -1,4 +1,9 @@
 #pragma once
 
 #include "./Status.h"
+#include "./Sink.h"
+#include "./Trace.h"
+#include "./AsyncOutput.h"
+#include "./Formatter.h"
 #include "./IOStream.h"
+#include "./BinaryLog.h"
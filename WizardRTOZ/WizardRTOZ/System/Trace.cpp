@@ -0,0 +1,150 @@
+#include "./Trace.h"
+#include "./Sink.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace System;
+
+std::atomic<bool> Trace::recording {false};
+std::atomic<Trace::Buffer*> Trace::first {nullptr};
+thread_local Trace::Owner Trace::owner;
+
+namespace {
+    /*
+     * Pairs of (ticks, nanoseconds) taken at start() and at export, to convert ticks to time.
+     */
+    uint64_t calibration_ticks = 0;
+    uint64_t calibration_time = 0;
+
+    uint64_t monotonicTime(void){
+        struct timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+    }
+}
+
+Trace::Owner::~Owner(void){
+    if (this->buffer != nullptr){
+        this->buffer->state.store(Trace::retired, std::memory_order_release);
+    }
+}
+
+void Trace::start(void){
+    if (calibration_ticks == 0){
+        calibration_time = monotonicTime();
+        calibration_ticks = Trace::now();
+    }
+    Trace::recording.store(true, std::memory_order_release);
+}
+
+void Trace::stop(void){
+    Trace::recording.store(false, std::memory_order_release);
+}
+
+void Trace::clear(void){
+    for (Buffer* buffer = Trace::first.load(std::memory_order_acquire) ; buffer != nullptr ; buffer = buffer->next){
+        uint8_t state = buffer->state.load(std::memory_order_acquire);
+        if (state == Trace::owned){
+            buffer->head.store(0, std::memory_order_release);
+        } else if (state != Trace::busy && buffer->state.compare_exchange_strong(state, Trace::busy, std::memory_order_acquire)){
+            buffer->head.store(0, std::memory_order_relaxed);
+            buffer->state.store(Trace::reusable, std::memory_order_release);
+        }
+    }
+}
+
+Trace::Buffer* Trace::acquire(void){
+    Buffer* buffer = nullptr;
+    for (Buffer* iterator = Trace::first.load(std::memory_order_acquire) ; iterator != nullptr ; iterator = iterator->next){
+        uint8_t state = Trace::reusable;
+        if (iterator->state.load(std::memory_order_relaxed) == Trace::reusable && iterator->state.compare_exchange_strong(state, Trace::busy, std::memory_order_acquire)){
+            buffer = iterator;
+            buffer->head.store(0, std::memory_order_relaxed);
+            buffer->thread_id = static_cast<uint32_t>(syscall(SYS_gettid));
+            buffer->state.store(Trace::owned, std::memory_order_release);
+            break;
+        }
+    }
+    if (buffer == nullptr){
+        buffer = new Buffer();
+        buffer->thread_id = static_cast<uint32_t>(syscall(SYS_gettid));
+        buffer->next = Trace::first.load(std::memory_order_relaxed);
+        while (!Trace::first.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed)){}
+    }
+    Trace::owner.buffer = buffer;
+    Trace::local_buffer = buffer;
+    return buffer;
+}
+
+size_t Trace::exportChrome(Sink& sink){
+    double nanoseconds_per_tick = 1.0;
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t ticks = Trace::now() - calibration_ticks;
+    uint64_t time = monotonicTime() - calibration_time;
+    nanoseconds_per_tick = (calibration_ticks == 0 || ticks == 0) ? 1.0 : static_cast<double>(time) / ticks;
+#endif
+    uint64_t origin = calibration_ticks;
+
+    const char* header = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    sink.write(header, strlen(header));
+    size_t amount_of_events = 0;
+    std::vector<Event> events(Trace::buffer_capacity);
+    char line[256];
+    for (Buffer* buffer = Trace::first.load(std::memory_order_acquire) ; buffer != nullptr ; buffer = buffer->next){
+
+        /*
+         * The ring of an exited thread is held busy while it is copied, so acquire() cannot reset
+         * it, and becomes reusable afterwards.
+         */
+        uint8_t state = buffer->state.load(std::memory_order_acquire);
+        if (state == Trace::busy || (state != Trace::owned && !buffer->state.compare_exchange_strong(state, Trace::busy, std::memory_order_acquire))){
+            continue;
+        }
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t tail = head > Trace::buffer_capacity ? head - Trace::buffer_capacity : 0;
+        for (uint64_t index = tail ; index < head ; index++){
+            events[index - tail] = buffer->events[index & (Trace::buffer_capacity - 1)];
+        }
+
+        /*
+         * The owner may have overwritten the oldest events during the copy: the event it is
+         * writing replaces index current_head - buffer_capacity.
+         */
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t current_head = buffer->head.load(std::memory_order_relaxed);
+        uint64_t valid = (current_head + 1) > Trace::buffer_capacity ? (current_head + 1 - Trace::buffer_capacity) : 0;
+        for (uint64_t index = (valid > tail ? valid : tail) ; index < head ; index++){
+            const Event& event = events[index - tail];
+            double timestamp = (event.timestamp > origin ? (event.timestamp - origin) : 0) * nanoseconds_per_tick / 1000.0;
+            int length = 0;
+            switch (event.type){
+                case Type::zone:
+                    length = snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                        amount_of_events == 0 ? "" : ",\n", event.name, timestamp, event.argument * nanoseconds_per_tick / 1000.0, buffer->thread_id);
+                    break;
+                case Type::instant:
+                    length = snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                        amount_of_events == 0 ? "" : ",\n", event.name, timestamp, buffer->thread_id);
+                    break;
+                case Type::counter:
+                    length = snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%lld}}",
+                        amount_of_events == 0 ? "" : ",\n", event.name, timestamp, buffer->thread_id, static_cast<long long>(event.argument));
+                    break;
+            }
+            if (length > 0){
+                sink.write(line, static_cast<size_t>(length) < sizeof(line) ? length : sizeof(line) - 1);
+                amount_of_events++;
+            }
+        }
+        if (state != Trace::owned){
+            buffer->state.store(Trace::reusable, std::memory_order_release);
+        }
+    }
+    sink.write("\n]}\n", 4);
+    sink.flush();
+    return amount_of_events;
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ * Build with -DSYSTEM_TRACE=0 to compile every TRACE_* macro out.
+ */
+#ifndef SYSTEM_TRACE
+#define SYSTEM_TRACE 1
+#endif
+
+#define _TRACE_CONCAT_INNER(a, b) a ## b
+#define _TRACE_CONCAT(a, b) _TRACE_CONCAT_INNER(a, b)
+
+#if SYSTEM_TRACE
+#define TRACE_ZONE(name) System::Trace::Zone _TRACE_CONCAT(_trace_zone_, __LINE__)(name)
+#define TRACE_INSTANT(name) System::Trace::instant(name)
+#define TRACE_COUNTER(name, value) System::Trace::counter(name, value)
+#else
+#define TRACE_ZONE(name) do {} while (0)
+#define TRACE_INSTANT(name) do {} while (0)
+#define TRACE_COUNTER(name, value) do {} while (0)
+#endif
+
+namespace System{
+
+    class Sink;
+
+    /**
+     * @class Trace
+     *
+     * @brief Per-thread binary event recorder, exported as Chrome trace JSON (opened by Perfetto).
+     *
+     * Every thread records into its own ring of buffer_capacity events, so recording is a
+     * timestamp and a 32 bytes store without any shared write. When a ring is full the oldest
+     * events are overwritten. Nothing is recorded between stop() and start(), which costs one
+     * relaxed load per event. Event names must be string literals.
+     */
+    class Trace{
+    public:
+        enum class Type : uint8_t {
+            zone,       ///< argument is the duration in ticks
+            instant,
+            counter,    ///< argument is the value
+        };
+
+        struct Event{
+            uint64_t timestamp;
+            uint64_t argument;
+            const char* name;
+            Type type;
+        };
+
+        static constexpr size_t buffer_capacity = 1 << 14;     ///< Events kept per thread
+
+        /**
+         * @class Zone
+         *
+         * @brief Records the time between its construction and its destruction.
+         */
+        class Zone{
+        private:
+            const char* const name;
+            uint64_t begin {0};
+        public:
+            inline Zone(const char* name) : name(name) {
+                if (Trace::isRecording()){
+                    this->begin = Trace::now();
+                }
+            }
+            inline ~Zone(void){
+                if (this->begin != 0 && Trace::isRecording()){
+                    Trace::record(Type::zone, this->name, this->begin, Trace::now() - this->begin);
+                }
+            }
+            Zone(const Zone&) = delete;
+            Zone& operator=(const Zone&) = delete;
+        };
+
+        static void start(void);
+        static void stop(void);
+
+        /**
+         * @brief Drop every recorded event, which also frees the rings of exited threads. Call it while stopped.
+         */
+        static void clear(void);
+
+        static inline bool isRecording(void){
+            return Trace::recording.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Timestamp in ticks: the time stamp counter on x86, nanoseconds elsewhere.
+         */
+        static inline uint64_t now(void){
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            struct timespec time;
+            clock_gettime(CLOCK_MONOTONIC, &time);
+            return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+#endif
+        }
+
+        static inline void instant(const char* name){
+            if (Trace::isRecording()){
+                Trace::record(Type::instant, name, Trace::now(), 0);
+            }
+        }
+        static inline void counter(const char* name, int64_t value){
+            if (Trace::isRecording()){
+                Trace::record(Type::counter, name, Trace::now(), static_cast<uint64_t>(value));
+            }
+        }
+
+        /**
+         * @brief Write every event still held by the rings to sink as Chrome trace JSON.
+         *
+         * Events overwritten while they were copied are skipped. The rings of exited threads are
+         * kept until they are exported, and reused by new threads afterwards. Run one export at a time.
+         *
+         * @return The amount of events written.
+         */
+        static size_t exportChrome(Sink& sink);
+    private:
+        /*
+         * A ring is only handed to a new thread once the events of its previous thread were
+         * exported or cleared. busy excludes acquire() and exportChrome() from each other.
+         */
+        static constexpr uint8_t owned = 0;         ///< Its thread records into it
+        static constexpr uint8_t retired = 1;       ///< Its thread exited before its events were exported
+        static constexpr uint8_t reusable = 2;      ///< Its thread exited and its events were exported or cleared
+        static constexpr uint8_t busy = 3;          ///< Reset for a new thread or copied by exportChrome
+
+        struct Buffer{
+            Buffer* next {nullptr};
+            std::atomic<uint8_t> state {Trace::owned};
+            uint32_t thread_id {0};
+            std::atomic<uint64_t> head {0};
+            Event events[Trace::buffer_capacity];
+        };
+
+        /*
+         * Retires the ring of its thread when the thread exits.
+         */
+        struct Owner{
+            Buffer* buffer {nullptr};
+            ~Owner(void);
+        };
+
+        static std::atomic<bool> recording;
+        static std::atomic<Buffer*> first;
+        static inline thread_local Buffer* local_buffer {nullptr};
+        static thread_local Owner owner;
+        static Buffer* acquire(void);
+
+        static inline void record(Type type, const char* name, uint64_t timestamp, uint64_t argument){
+            Buffer* buffer = Trace::local_buffer;
+            if (buffer == nullptr){
+                buffer = Trace::acquire();
+            }
+            uint64_t head = buffer->head.load(std::memory_order_relaxed);
+            Event& event = buffer->events[head & (Trace::buffer_capacity - 1)];
+            event.timestamp = timestamp;
+            event.argument = argument;
+            event.name = name;
+            event.type = type;
+            buffer->head.store(head + 1, std::memory_order_release);
+        }
+    };
+}
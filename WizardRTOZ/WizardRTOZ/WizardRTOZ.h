@@ -2,3 +2,5 @@
 
 #include "./System/System.h"
 #include "./MemoryManager/MemoryManager.h"
+#include "./Communication/Communication.h"
+#include "./Synchronization/Synchronization.h"
@@ -1,7 +1,15 @@
 #include "./WizardRTOZ/WizardRTOZ.h"
 #include "./UnitTest/UnitTest.h"
 
+#include <fcntl.h>
 #include <inttypes.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
 
 UNIT_TEST_BEGIN
 {
@@ -124,8 +132,1140 @@ UNIT_TEST_BEGIN
 }
 UNIT_TEST_END
 
-int main()
+UNIT_TEST_BEGIN
+{
+    MemoryManager::MemoryPool<uint32_t, 16> pool;
+    Communication::SPSCQueue<MemoryManager::MemoryPool<uint32_t, 16>::Reference, 4> queue;
+    MemoryManager::MemoryPool<uint32_t, 16>::Reference references[4];
+
+    // Testing SPSCQueue::push (handles are moved, not copied)
+    for (uint32_t index = 0 ; index < 4 ; index++){
+        references[index] = pool.allocate();
+        references[index] = index;
+    }
+    uint32_t* payload = references[0].begin();
+    UNIT_TEST_COMPARE(queue.push(references, 4), 4);
+    UNIT_TEST_ASSERT(references[0].isEmpty());
+    UNIT_TEST_COMPARE(pool.getFreeSpace(), 12);
+
+    // Testing SPSCQueue::push (full)
+    references[0] = pool.allocate();
+    UNIT_TEST_ASSERT(queue.push(references[0]) == false);
+    UNIT_TEST_ASSERT(references[0].isEmpty() == false);
+    references[0].release();
+
+    // Testing SPSCQueue::pop
+    MemoryManager::MemoryPool<uint32_t, 16>::Reference reference;
+    UNIT_TEST_ASSERT(queue.pop(reference));
+    UNIT_TEST_ASSERT(reference.begin() == payload);
+    UNIT_TEST_COMPARE(reference.getData(), 0);
+    UNIT_TEST_COMPARE(queue.pop(references, 4), 3);
+    UNIT_TEST_COMPARE(references[2].getData(), 3);
+    UNIT_TEST_ASSERT(queue.isEmpty());
+
+    // Testing MPSCQueue::push/pop
+    Communication::MPSCQueue<MemoryManager::MemoryPool<uint32_t, 16>::Reference> mpsc_queue;
+    Communication::MPSCQueue<MemoryManager::MemoryPool<uint32_t, 16>::Reference>::Element elements[2];
+    elements[0].setData(std::move(reference));
+    elements[1].setData(std::move(references[2]));
+    UNIT_TEST_ASSERT(mpsc_queue.isEmpty());
+    mpsc_queue.push(elements[0]);
+    mpsc_queue.push(elements[1]);
+    UNIT_TEST_ASSERT(mpsc_queue.pop() == &elements[0]);
+    UNIT_TEST_ASSERT(mpsc_queue.pop() == &elements[1]);
+    UNIT_TEST_ASSERT(mpsc_queue.pop() == nullptr);
+    UNIT_TEST_ASSERT(mpsc_queue.isEmpty());
+    mpsc_queue.push(elements[0]);
+    UNIT_TEST_ASSERT(mpsc_queue.pop() == &elements[0]);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    // Testing Mutex (parked waiters are woken by priority)
+    static Synchronization::Mutex mutex;
+    static uint8_t order[3] = {0};
+    static size_t order_position = 0;
+    std::thread threads[3];
+    const uint8_t priorities[3] = {5, 1, 3};
+    mutex.lock();
+    for (size_t index = 0 ; index < 3 ; index++){
+        threads[index] = std::thread([](uint8_t priority){
+            mutex.lock(priority);
+            order[order_position++] = priority;
+            mutex.unlock();
+        }, priorities[index]);
+        while (mutex.getContentionCounters().parked != index + 1){
+            std::this_thread::yield();
+        }
+    }
+    mutex.unlock();
+    for (auto& thread : threads){
+        thread.join();
+    }
+    UNIT_TEST_COMPARE(order[0], 1);
+    UNIT_TEST_COMPARE(order[1], 3);
+    UNIT_TEST_COMPARE(order[2], 5);
+    UNIT_TEST_ASSERT(mutex.tryLock());
+    UNIT_TEST_ASSERT(mutex.tryLock() == false);
+    mutex.unlock();
+
+    // Testing Semaphore
+    Synchronization::Semaphore semaphore(2);
+    UNIT_TEST_ASSERT(semaphore.tryAcquire());
+    UNIT_TEST_ASSERT(semaphore.tryAcquire());
+    UNIT_TEST_ASSERT(semaphore.tryAcquire() == false);
+    std::thread releaser([&semaphore](){ semaphore.release(); });
+    semaphore.acquire();
+    releaser.join();
+    UNIT_TEST_COMPARE(semaphore.getCount(), 0);
+
+    // Testing EventFlags
+    Synchronization::EventFlags event_flags;
+    std::thread setter([&event_flags](){
+        event_flags.set(0b001);
+        event_flags.set(0b100);
+    });
+    uint32_t flags = event_flags.wait(0b101, Synchronization::EventFlags::Mode::all, true);
+    setter.join();
+    UNIT_TEST_COMPARE(flags, 0b101);
+    UNIT_TEST_COMPARE(event_flags.get(), 0);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    using Bus = Communication::MessageBus<uint32_t, 4, 4>;
+    static Bus bus;
+    Bus::Topic topic(2, Communication::DropPolicy::drop_oldest);
+    Bus::Subscriber first_subscriber(topic);
+    Bus::Subscriber second_subscriber(topic);
+
+    // Testing MessageBus::allocate/Topic::publish (subscribers share the block)
+    Bus::Message message = bus.allocate();
+    *message = 10;
+    UNIT_TEST_COMPARE(topic.publish(message), 2);
+    UNIT_TEST_COMPARE(message.getReferences(), 3);
+    UNIT_TEST_COMPARE(bus.getFreeSpace(), 3);
+
+    Bus::Message received;
+    UNIT_TEST_ASSERT(first_subscriber.tryReceive(received));
+    UNIT_TEST_ASSERT(&received.getData() == &message.getData());
+    received.release();
+    message.release();
+    UNIT_TEST_COMPARE(bus.getFreeSpace(), 3);
+    second_subscriber.receive(received);
+    UNIT_TEST_COMPARE(*received, 10);
+    received.release();
+    UNIT_TEST_COMPARE(bus.getFreeSpace(), 4);
+
+    // Testing DropPolicy::drop_oldest
+    for (uint32_t value = 0 ; value < 3 ; value++){
+        message = bus.allocate();
+        *message = value;
+        topic.publish(message);
+    }
+    message.release();
+    UNIT_TEST_COMPARE(first_subscriber.getDropped(), 1);
+    UNIT_TEST_COMPARE(bus.getFreeSpace(), 2);
+    UNIT_TEST_ASSERT(first_subscriber.tryReceive(received));
+    UNIT_TEST_COMPARE(*received, 1);
+    UNIT_TEST_ASSERT(first_subscriber.tryReceive(received));
+    UNIT_TEST_COMPARE(*received, 2);
+    UNIT_TEST_ASSERT(first_subscriber.tryReceive(received) == false);
+
+    // Testing DropPolicy::drop_newest
+    Bus::Topic lossy_topic(1, Communication::DropPolicy::drop_newest);
+    Bus::Subscriber lossy_subscriber(lossy_topic);
+    message = bus.allocate();
+    UNIT_TEST_COMPARE(lossy_topic.publish(message), 1);
+    UNIT_TEST_COMPARE(lossy_topic.publish(message), 0);
+    UNIT_TEST_COMPARE(lossy_subscriber.getDropped(), 1);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    int pipe_descriptors[2];
+    UNIT_TEST_ASSERT(pipe(pipe_descriptors) == 0);
+    char long_message[301];
+    memset(long_message, 'x', 300);
+    long_message[300] = 0;
+
+    // Testing IOStream with an AsyncOutput (no truncation, ordered writes)
+    {
+        System::AsyncOutputBuffer<1024> output(pipe_descriptors[1]);
+        System::IOStream::attach(output);
+        System::IOStream::printf("%s%d", long_message, 42);
+        System::IOStream::write("abc");
+        System::IOStream::printer << 'd';
+        System::IOStream::detach();
+        UNIT_TEST_COMPARE(output.getDropped(), 0);
+    }
+    char received[400] = {0};
+    ssize_t received_size = read(pipe_descriptors[0], received, sizeof(received));
+    UNIT_TEST_COMPARE(received_size, 306);
+    UNIT_TEST_ASSERT(memcmp(received, long_message, 300) == 0);
+    UNIT_TEST_ASSERT(memcmp(received + 300, "42abcd", 6) == 0);
+
+    // Testing AsyncOutput::write (messages larger than the ring)
+    {
+        System::AsyncOutputBuffer<64> output(pipe_descriptors[1]);
+        UNIT_TEST_ASSERT(output.write(long_message, 300));
+        output.flush();
+    }
+    received_size = read(pipe_descriptors[0], received, sizeof(received));
+    UNIT_TEST_COMPARE(received_size, 300);
+    close(pipe_descriptors[0]);
+    close(pipe_descriptors[1]);
+
+    // Testing OverflowPolicy::overwrite (concurrent writers never share ring bytes)
+    System::MemorySink sink;
+    {
+        System::AsyncOutputBuffer<256> output(sink, System::OverflowPolicy::overwrite);
+        std::thread writers[4];
+        for (size_t writer = 0 ; writer < 4 ; writer++){
+            writers[writer] = std::thread([&output, writer](){
+                char line[24];
+                memset(line, 'a' + writer, sizeof(line) - 1);
+                line[sizeof(line) - 1] = '\n';
+                for (size_t index = 0 ; index < 2000 ; index++){
+                    output.write(line, sizeof(line));
+                }
+            });
+        }
+        for (std::thread& writer : writers){
+            writer.join();
+        }
+    }
+    std::string lines(sink.getSize(), 0);
+    sink.read(&lines[0], lines.size());
+    bool torn = false;
+    for (size_t begin = 0, end = 0 ; begin < lines.size() ; begin = end + 1){
+        end = lines.find('\n', begin);
+        end = end == std::string::npos ? lines.size() : end;
+        torn = torn || (end - begin) > 23 || lines.find_first_not_of(lines[begin], begin) < end;
+    }
+    UNIT_TEST_ASSERT(torn == false);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    int pipe_descriptors[2];
+    UNIT_TEST_ASSERT(pipe(pipe_descriptors) == 0);
+
+    // Testing BinaryLog (entries are only decoded after the fact)
+    {
+        System::AsyncOutputBuffer<1024> output(pipe_descriptors[1]);
+        System::BinaryLog::open(output);
+        for (int index = 0 ; index < 2 ; index++){
+            BINARY_LOG("sensor %d reads %u at %.1f\r\n", index, 40000u + index, 2.5);
+        }
+        BINARY_LOG("%s %c %llx\r\n", "name", 'z', static_cast<unsigned long long>(0xABCDEF));
+        BINARY_LOG("no arguments\r\n");
+        System::BinaryLog::close();
+    }
+    uint8_t dump[1024];
+    ssize_t dump_size = read(pipe_descriptors[0], dump, sizeof(dump));
+    UNIT_TEST_ASSERT(dump_size > 0);
+    std::string text;
+    size_t decoded = System::BinaryLog::decode(dump, dump_size, [&text](const char* message, size_t size){
+        text.append(strchr(message, ']') + 2, message + size);
+    });
+    UNIT_TEST_COMPARE(decoded, static_cast<size_t>(dump_size));
+    UNIT_TEST_ASSERT(text == "sensor 0 reads 40000 at 2.5\r\nsensor 1 reads 40001 at 2.5\r\nname z abcdef\r\nno arguments\r\n");
+
+    // Testing BinaryLog::decode (a dump cut in the middle of a block)
+    UNIT_TEST_ASSERT(System::BinaryLog::decode(dump, dump_size - 1, [](const char*, size_t){}) < static_cast<size_t>(dump_size));
+
+    // Testing BinaryLog::decode (corrupt dictionary blocks are dropped, not read past their end)
+    size_t dictionary = 0;
+    uint32_t dictionary_size = 0;
+    for (size_t position = sizeof(System::BinaryLog::magic) ; position + System::BinaryLog::block_header_size <= static_cast<size_t>(dump_size) ; position = dictionary + dictionary_size){
+        memcpy(&dictionary_size, dump + position + 1, sizeof(dictionary_size));
+        dictionary = position + System::BinaryLog::block_header_size;
+        std::string body(reinterpret_cast<const char*>(dump + dictionary), dictionary_size);
+        if (dump[position] == static_cast<uint8_t>(System::BinaryLog::Block::dictionary) && body.find("no arguments") != std::string::npos){
+            break;
+        }
+    }
+    for (int corruption = 0 ; corruption < 2 ; corruption++){
+        std::vector<uint8_t> corrupt(dump, dump + dump_size);
+        if (corruption == 0){
+            corrupt[dictionary + 2] = 0xFF;
+        } else {
+            corrupt[dictionary + dictionary_size - 1] = 'x';
+        }
+        text.clear();
+        decoded = System::BinaryLog::decode(corrupt.data(), corrupt.size(), [&text](const char* message, size_t size){
+            text.append(strchr(message, ']') + 2, message + size);
+        });
+        UNIT_TEST_COMPARE(decoded, static_cast<size_t>(dump_size));
+        UNIT_TEST_ASSERT(text.find("sensor 0 reads 40000 at 2.5\r\nsensor 1 reads 40001 at 2.5\r\nname z abcdef\r\n<unknown format") == 0);
+    }
+
+    // Testing BinaryLog::open (a sink cutting records is rejected)
+    {
+        System::AsyncOutputBuffer<1024> output(pipe_descriptors[1], System::OverflowPolicy::overwrite);
+        System::TeeSink tee(output, output);
+        UNIT_TEST_ASSERT(System::BinaryLog::open(output) == false);
+        UNIT_TEST_ASSERT(System::BinaryLog::open(tee) == false);
+    }
+    close(pipe_descriptors[0]);
+    close(pipe_descriptors[1]);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    char buffer[System::Formatter::max_size];
+    System::FormatOptions options;
+
+    // Testing Formatter::format (integers)
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, -1234)) == "-1234");
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, UINT64_MAX)) == "18446744073709551615");
+    options.base = 16;
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, static_cast<int8_t>(-1), options)) == "ff");
+    options.width = 8;
+    options.fill = '0';
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, 0xBEEFu, options)) == "0000beef");
+    options.base = 10;
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, -42, options)) == "-0000042");
+
+    // Testing Formatter::format (floating points and pointers)
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, 3.14159f)) == "3.14");
+    options = System::FormatOptions();
+    options.precision = -1;
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, 0.1, options)) == "0.1");
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, 1e300, options)) == "1e+300");
+    options.precision = 127;
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, 0.5, options)) == "0." + std::string(System::Formatter::max_precision, '0').replace(0, 1, "5"));
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, -1.5e300, options)).find("e+300") == static_cast<size_t>(System::Formatter::max_precision) + 3);
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, reinterpret_cast<void*>(0x1F))) == "0x1f");
+    options.width = 8;
+    options.fill = '0';
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, reinterpret_cast<void*>(0x1F), options)) == "0x00001f");
+    options.fill = ' ';
+    UNIT_TEST_ASSERT(std::string(buffer, System::Formatter::format(buffer, reinterpret_cast<void*>(0x1F), options)) == "    0x1f");
+
+    // Testing IOStream manipulators (the width applies to one value)
+    int pipe_descriptors[2];
+    UNIT_TEST_ASSERT(pipe(pipe_descriptors) == 0);
+    {
+        System::AsyncOutputBuffer<256> output(pipe_descriptors[1]);
+        System::IOStream stream;
+        System::IOStream::attach(output);
+        stream << System::hex << System::width(4) << 255u << ' ' << 255 << System::dec << ' ' << static_cast<size_t>(5000000000ull);
+        stream << ' ' << System::precision(3) << 2.5f << ' ' << "text";
+        System::IOStream::detach();
+    }
+    char received[64] = {0};
+    UNIT_TEST_ASSERT(read(pipe_descriptors[0], received, sizeof(received)) > 0);
+    UNIT_TEST_ASSERT(strcmp(received, "  ff ff 5000000000 2.500 text") == 0);
+    close(pipe_descriptors[0]);
+    close(pipe_descriptors[1]);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    char received[64] = {0};
+    struct iovec fragments[3] = {
+        {const_cast<char*>("one "), 4},
+        {const_cast<char*>("two "), 4},
+        {const_cast<char*>("three"), 5},
+    };
+
+    // Testing MemorySink and TeeSink (gathered fragments)
+    System::MemorySink first;
+    System::MemorySink second;
+    System::TeeSink tee(first, second);
+    UNIT_TEST_ASSERT(first.getFileDescriptor() >= 0);
+    UNIT_TEST_ASSERT(tee.write(fragments, 3));
+    UNIT_TEST_ASSERT(tee.write("!", 1));
+    UNIT_TEST_COMPARE(first.getSize(), 14);
+    UNIT_TEST_COMPARE(second.read(received, sizeof(received)), 14);
+    UNIT_TEST_ASSERT(memcmp(received, "one two three!", 14) == 0);
+    UNIT_TEST_COMPARE(first.read(received, 5, 4), 5);
+    UNIT_TEST_ASSERT(memcmp(received, "two t", 5) == 0);
+    first.clear();
+    UNIT_TEST_COMPARE(first.getSize(), 0);
+
+    // Testing AsyncOutput and IOStream writing to a Sink
+    {
+        System::AsyncOutputBuffer<64> output(first);
+        System::IOStream::attach(output);
+        System::IOStream::write(fragments, 3);
+        System::IOStream::printer << ' ' << 42;
+        System::IOStream::detach();
+    }
+    UNIT_TEST_COMPARE(first.read(received, sizeof(received)), 16);
+    UNIT_TEST_ASSERT(memcmp(received, "one two three 42", 16) == 0);
+
+    // Testing StreamSink (writes go through the stdio buffer)
+    FILE* stream = tmpfile();
+    System::StreamSink stream_sink(stream);
+    UNIT_TEST_ASSERT(stream_sink.write(fragments, 3));
+    fputs(" four", stream);
+    UNIT_TEST_COMPARE(ftell(stream), 18);
+    stream_sink.flush();
+    UNIT_TEST_COMPARE(pread(fileno(stream), received, sizeof(received), 0), 18);
+    UNIT_TEST_ASSERT(memcmp(received, "one two three four", 18) == 0);
+    fclose(stream);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    // Testing Exception::test (non-owning treatment callback)
+    int treated = 0;
+    auto treatment = [&treated](const System::Exception& exception){
+        treated++;
+        return exception == System::Exceptions::domain_error;
+    };
+    UNIT_TEST_ASSERT(System::Exceptions::domain_error.test(false, "Not raised.", treatment));
+    UNIT_TEST_COMPARE(treated, 0);
+    if (System::check_policy == System::CheckPolicy::full){
+        UNIT_TEST_ASSERT(System::Exceptions::domain_error.test(true, "Raised on purpose.", treatment));
+        UNIT_TEST_COMPARE(treated, 1);
+        UNIT_TEST_ASSERT(System::Exceptions::out_of_range.test(true, "Raised on purpose.") == false);
+    }
+
+    // Testing Exception::check
+    UNIT_TEST_ASSERT(System::Exceptions::out_of_range.check(false) == System::Status::ok);
+    UNIT_TEST_ASSERT(System::Exceptions::out_of_range.check(true) == System::Status::out_of_range);
+    UNIT_TEST_ASSERT(System::Exceptions::logic_error.check(true) != System::Status::ok);
+
+    // Testing Exception::guard (full containers are detected under every check policy)
+    UNIT_TEST_ASSERT(System::Exceptions::out_of_range.guard(false));
+    UNIT_TEST_ASSERT(System::Exceptions::out_of_range.guard(true, "Raised on purpose.") == false);
+    MemoryManager::MemoryPool<uint8_t, 2> full_pool;
+    auto full_block = full_pool.allocate(2);
+    UNIT_TEST_ASSERT(full_pool.allocate(1).isEmpty());
+    UNIT_TEST_COMPARE(full_pool.getFreeSpace(), 0);
+
+    // Testing BitArray::tryGet and BitArray::tryWrite
+    MemoryManager::BitArray<16> bit_array;
+    bool bit = false;
+    UNIT_TEST_ASSERT(bit_array.tryWrite(9, true) == System::Status::ok);
+    UNIT_TEST_ASSERT(bit_array.tryGet(9, bit) == System::Status::ok);
+    UNIT_TEST_ASSERT(bit);
+    UNIT_TEST_ASSERT(bit_array.tryGet(16, bit) == System::Status::out_of_range);
+    UNIT_TEST_ASSERT(bit_array.tryWrite(3, true, 0) == System::Status::length_error);
+    bit_array.fill(3, 11, true);
+    UNIT_TEST_ASSERT(bit_array.any(3, 1) && bit_array.any(13, 1) && bit_array.any(0, 3) == false && bit_array.any(14, 2) == false);
+    bit_array.fill(4, 9, false);
+    UNIT_TEST_ASSERT(bit_array.any(4, 9) == false && bit_array.get(3) && bit_array.get(13));
+
+    // Testing MemoryPool::tryAllocate and Reference::tryGetData
+    MemoryManager::MemoryPool<uint32_t, 4> pool;
+    MemoryManager::MemoryPool<uint32_t, 4>::Reference reference;
+    uint32_t* data = nullptr;
+    UNIT_TEST_ASSERT(pool.tryAllocate(reference, 5) == System::Status::length_error);
+    UNIT_TEST_ASSERT(reference.isEmpty());
+    UNIT_TEST_ASSERT(pool.tryAllocate(reference, 3) == System::Status::ok);
+    UNIT_TEST_ASSERT(reference.trySetData(7, 2) == System::Status::ok);
+    UNIT_TEST_ASSERT(reference.tryGetData(data, 2) == System::Status::ok);
+    UNIT_TEST_COMPARE(*data, 7);
+    UNIT_TEST_ASSERT(reference.tryGetData(data, 3) == System::Status::length_error);
+    MemoryManager::MemoryPool<uint32_t, 4>::Reference other;
+    UNIT_TEST_ASSERT(pool.tryAllocate(other, 2) == System::Status::out_of_range);
+    UNIT_TEST_ASSERT(pool.tryAllocate(other, 1) == System::Status::ok);
+    UNIT_TEST_COMPARE(pool.getFreeSpace(), 0);
+    UNIT_TEST_ASSERT(pool.tryGetData(data, 2) == System::Status::ok);
+    UNIT_TEST_COMPARE(*data, 7);
+
+    // Testing MemoryPool::allocate (blocks longer than a byte of tags)
+    MemoryManager::MemoryPool<uint8_t, 600> large_pool;
+    auto first_block = large_pool.allocate(300);
+    auto second_block = large_pool.allocate(290);
+    UNIT_TEST_COMPARE(large_pool.getFreeSpace(), 10);
+    first_block.release();
+    auto third_block = large_pool.allocate(299);
+    UNIT_TEST_ASSERT(third_block.begin() == large_pool.begin());
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    MemoryManager::MemoryPool<uint32_t, 8> pool;
+    System::MemorySink sink;
+    std::string json;
+
+    // Testing Trace (nothing is recorded while stopped)
+    System::Trace::clear();
+    pool.allocate(2);
+    UNIT_TEST_COMPARE(System::Trace::exportChrome(sink), 0);
+
+    // Testing Trace (zones, instants and counters from two threads)
+    sink.clear();
+    System::Trace::start();
+    {
+        TRACE_ZONE("main");
+        auto reference = pool.allocate(2);
+        TRACE_INSTANT("allocated");
+        TRACE_COUNTER("free space", pool.getFreeSpace());
+        std::thread worker([](){
+            TRACE_ZONE("worker");
+        });
+        worker.join();
+    }
+    System::Trace::stop();
+    UNIT_TEST_COMPARE(System::Trace::exportChrome(sink), 6);
+    json.resize(sink.getSize());
+    sink.read(&json[0], json.size());
+    UNIT_TEST_ASSERT(json.find("\"traceEvents\"") != std::string::npos);
+    UNIT_TEST_ASSERT(json.find("{\"name\":\"MemoryPool::allocate\",\"ph\":\"X\"") != std::string::npos);
+    UNIT_TEST_ASSERT(json.find("{\"name\":\"MemoryPool::free\",\"ph\":\"X\"") != std::string::npos);
+    UNIT_TEST_ASSERT(json.find("{\"name\":\"allocated\",\"ph\":\"i\"") != std::string::npos);
+    UNIT_TEST_ASSERT(json.find("\"args\":{\"value\":6}") != std::string::npos);
+    UNIT_TEST_ASSERT(json.find("{\"name\":\"worker\",\"ph\":\"X\"") != std::string::npos);
+
+    // Testing Trace (a full ring keeps the newest events)
+    sink.clear();
+    System::Trace::clear();
+    System::Trace::start();
+    for (size_t index = 0 ; index < System::Trace::buffer_capacity + 100 ; index++){
+        TRACE_COUNTER("index", index);
+    }
+    System::Trace::stop();
+    size_t amount_of_events = System::Trace::exportChrome(sink);
+    UNIT_TEST_ASSERT(amount_of_events >= System::Trace::buffer_capacity - 1 && amount_of_events <= System::Trace::buffer_capacity);
+    System::Trace::clear();
+
+    // Testing Trace (the ring of an exited thread is only reused once exported)
+    sink.clear();
+    System::Trace::start();
+    std::thread([](){ TRACE_INSTANT("first worker"); }).join();
+    std::thread([](){ TRACE_INSTANT("second worker"); }).join();
+    System::Trace::stop();
+    UNIT_TEST_COMPARE(System::Trace::exportChrome(sink), 2);
+    sink.clear();
+    System::Trace::start();
+    std::thread([](){ TRACE_INSTANT("third worker"); }).join();
+    System::Trace::stop();
+    UNIT_TEST_COMPARE(System::Trace::exportChrome(sink), 2);
+    json.resize(sink.getSize());
+    sink.read(&json[0], json.size());
+    UNIT_TEST_ASSERT(json.find("third worker") != std::string::npos);
+    System::Trace::clear();
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    using Pool = MemoryManager::SharedMemoryPool<uint32_t, 200>;
+    Pool pool;
+
+    // Testing SharedMemoryPool::allocate (blocks across bitmap words)
+    Pool::Reference small = pool.allocate(10);
+    Pool::Reference large = pool.allocate(130);
+    UNIT_TEST_COMPARE(small.getOffset().position, 0);
+    UNIT_TEST_COMPARE(large.getOffset().position, 10);
+    UNIT_TEST_COMPARE(pool.getFreeSpace(), 60);
+    Pool::Reference full;
+    UNIT_TEST_ASSERT(pool.tryAllocate(full, 61) == System::Status::out_of_range);
+    UNIT_TEST_ASSERT(full.isEmpty());
+
+    // Testing SharedMemoryPool (a forked process resolves, writes and frees a detached block)
+    for (uint32_t index = 0 ; index < 130 ; index++){
+        large[index] = index;
+    }
+    Pool::Offset offset = large.detach();
+    UNIT_TEST_ASSERT(large.isEmpty());
+    pid_t process = fork();
+    if (process == 0){
+        uint32_t* data = pool.resolve(offset);
+        uint32_t sum = 0;
+        for (uint32_t index = 0 ; index < 130 ; index++){
+            sum += data[index];
+        }
+        data[0] = sum;
+        pool.free(offset);
+        _exit(0);
+    }
+    int status = -1;
+    waitpid(process, &status, 0);
+    UNIT_TEST_COMPARE(status, 0);
+    UNIT_TEST_COMPARE(*pool.resolve(offset), 129 * 130 / 2);
+    UNIT_TEST_COMPARE(pool.getFreeSpace(), 190);
+    UNIT_TEST_COMPARE(pool.allocate(40).getOffset().position, 10);
+
+    // Testing SharedMemoryPool::adopt
+    Pool::Reference adopted = pool.adopt(small.detach());
+    UNIT_TEST_COMPARE(adopted.getLenght(), 10);
+    adopted.release();
+    UNIT_TEST_COMPARE(pool.getFreeSpace(), 200);
+    UNIT_TEST_ASSERT(small.isEmpty());
+    UNIT_TEST_ASSERT(pool.adopt({10, 3}).isEmpty());
+    pool.free(Pool::Offset{10, 3});
+    UNIT_TEST_COMPARE(pool.getFreeSpace(), 200);
+
+    // Testing SharedMemoryPool (named object attached twice)
+    char name[64];
+    snprintf(name, sizeof(name), "/wizardrtoz-test-%d", static_cast<int>(getpid()));
+    Pool::remove(name);
+    {
+        Pool owner(name);
+        Pool attached(name);
+        UNIT_TEST_ASSERT(owner.isAttached() && attached.isAttached());
+        using Smaller = MemoryManager::SharedMemoryPool<uint32_t, 100>;
+        UNIT_TEST_ASSERT(Smaller(name).isAttached() == false);
+        Pool::Reference reference = owner.allocate(3);
+        reference[2] = 0xCAFE;
+        UNIT_TEST_COMPARE(attached.getFreeSpace(), 197);
+        UNIT_TEST_COMPARE(attached.resolve(reference.getOffset())[2], 0xCAFE);
+        attached.free(reference.detach());
+        UNIT_TEST_COMPARE(owner.getFreeSpace(), 200);
+    }
+    Pool::remove(name);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    using Map = MemoryManager::SlotMap<int, 4>;
+    Map map;
+    Map::Handle empty;
+
+    // Testing SlotMap::insert
+    UNIT_TEST_ASSERT(map.get(empty) == nullptr);
+    Map::Handle first = map.insert(10);
+    Map::Handle second = map.insert(20);
+    Map::Handle third = map.insert(30);
+    UNIT_TEST_COMPARE(map.getSize(), 3);
+    UNIT_TEST_COMPARE(map[second], 20);
+    UNIT_TEST_ASSERT(map.get(empty) == nullptr);
+
+    // Testing SlotMap::erase (the last value fills the hole, old handles stop resolving)
+    UNIT_TEST_ASSERT(map.erase(first));
+    UNIT_TEST_ASSERT(map.erase(first) == false);
+    UNIT_TEST_ASSERT(map.get(first) == nullptr);
+    UNIT_TEST_COMPARE(map.getSize(), 2);
+    UNIT_TEST_COMPARE(*map.begin(), 30);
+    UNIT_TEST_COMPARE(map[third], 30);
+    UNIT_TEST_ASSERT(map.getHandle(0) == third);
+
+    // Testing SlotMap (a reused slot gets a new generation)
+    Map::Handle fourth = map.insert(40);
+    UNIT_TEST_COMPARE(fourth.value & 3, first.value & 3);
+    UNIT_TEST_ASSERT(fourth != first);
+    UNIT_TEST_ASSERT(map.get(first) == nullptr);
+    UNIT_TEST_COMPARE(map[fourth], 40);
+    int sum = 0;
+    for (int value : map){
+        sum += value;
+    }
+    UNIT_TEST_COMPARE(sum, 90);
+
+    // Testing SlotMap::tryInsert (full)
+    Map::Handle handle;
+    UNIT_TEST_ASSERT(map.tryInsert(handle, 50) == System::Status::ok);
+    UNIT_TEST_ASSERT(map.tryInsert(handle, 60) == System::Status::out_of_range);
+    UNIT_TEST_COMPARE(map[handle], 50);
+
+    // Testing SlotMap::clear
+    map.clear();
+    UNIT_TEST_ASSERT(map.isEmpty());
+    UNIT_TEST_ASSERT(map.contains(handle) == false);
+    UNIT_TEST_ASSERT(map.contains(map.insert(70)));
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    // A hash that sends every key to the same bucket, to test long probe sequences
+    struct Collide{
+        inline size_t operator()(int){
+            return 0;
+        }
+    };
+    MemoryManager::StaticHashMap<int, int, 8, Collide> colliding;
+    MemoryManager::StaticHashMap<int, std::string, 16> map;
+
+    // Testing StaticHashMap::insert
+    UNIT_TEST_ASSERT(map.find(1) == nullptr);
+    UNIT_TEST_COMPARE(*map.insert(1, "one"), "one");
+    map.insert(2, "two");
+    map[3] = "three";
+    UNIT_TEST_COMPARE(map.getSize(), 3);
+    UNIT_TEST_COMPARE(*map.find(2), "two");
+    map.insert(2, "dos");
+    UNIT_TEST_COMPARE(map.getSize(), 3);
+    UNIT_TEST_COMPARE(map[2], "dos");
+
+    // Testing StaticHashMap::erase
+    UNIT_TEST_ASSERT(map.erase(2));
+    UNIT_TEST_ASSERT(map.erase(2) == false);
+    UNIT_TEST_ASSERT(map.contains(2) == false);
+    UNIT_TEST_COMPARE(map[1], "one");
+    UNIT_TEST_COMPARE(map[3], "three");
+
+    // Testing StaticHashMap (full table, every key in the same bucket)
+    for (int key = 0 ; key < 8 ; key++){
+        UNIT_TEST_ASSERT(colliding.tryInsert(key, key * 10) == System::Status::ok);
+    }
+    UNIT_TEST_ASSERT(colliding.tryInsert(8, 80) == System::Status::out_of_range);
+    UNIT_TEST_ASSERT(colliding.tryInsert(7, 70) == System::Status::ok);
+    UNIT_TEST_ASSERT(colliding.find(8) == nullptr);
+    UNIT_TEST_ASSERT(colliding.erase(0));
+    UNIT_TEST_ASSERT(colliding.erase(4));
+    int sum = 0;
+    for (auto& entry : colliding){
+        UNIT_TEST_COMPARE(*colliding.find(entry.key), entry.key == 7 ? 70 : entry.key * 10);
+        sum += entry.key;
+    }
+    UNIT_TEST_COMPARE(sum, 1 + 2 + 3 + 5 + 6 + 7);
+    UNIT_TEST_COMPARE(colliding.getSize(), 6);
+
+    // Testing StaticHashMap::operator[] (full table)
+    MemoryManager::StaticHashMap<int, int, 4> small;
+    for (int key = 0 ; key < 4 ; key++){
+        small[key] = key + 1;
+    }
+    small[4] = 5;
+    UNIT_TEST_COMPARE(small.getSize(), 4);
+    UNIT_TEST_ASSERT(small.contains(4) == false);
+    UNIT_TEST_COMPARE(small[4], 0);
+    for (int key = 0 ; key < 4 ; key++){
+        UNIT_TEST_COMPARE(*small.find(key), key + 1);
+    }
+
+    // Testing StaticHashMap::clear
+    map.clear();
+    UNIT_TEST_ASSERT(map.isEmpty());
+    UNIT_TEST_ASSERT(map.begin() == map.end());
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
+{
+    enum Field { x, y, id };
+    using Table = MemoryManager::StructOfArrays<4, float, double, uint8_t>;
+    Table table;
+
+    // Testing StructOfArrays::append
+    UNIT_TEST_COMPARE(table.append(1.0f, 10.0, 1), 0);
+    UNIT_TEST_COMPARE(table.append(2.0f, 20.0, 2), 1);
+    UNIT_TEST_ASSERT(table.tryAppend(3.0f, 30.0, 3) == System::Status::ok);
+    UNIT_TEST_COMPARE(table.getSize(), 3);
+    UNIT_TEST_COMPARE(reinterpret_cast<uintptr_t>(table.getColumn<x>().begin()) & (Table::alignment - 1), 0);
+    UNIT_TEST_COMPARE(reinterpret_cast<uintptr_t>(table.getColumn<y>().begin()) & (Table::alignment - 1), 0);
+    UNIT_TEST_COMPARE(reinterpret_cast<uintptr_t>(table.getColumn<id>().begin()) & (Table::alignment - 1), 0);
+
+    // Testing StructOfArrays::getColumn
+    double sum = 0;
+    auto xs = table.getColumn<x>();
+    auto ys = table.getColumn<y>();
+    for (size_t row = 0 ; row < xs.size ; row++){
+        sum += xs[row] * ys[row];
+    }
+    UNIT_TEST_COMPARE(sum, 140.0);
+
+    // Testing StructOfArrays::Row
+    table[1].get<y>() = 25.0;
+    UNIT_TEST_COMPARE(table.getColumn<y>()[1], 25.0);
+    table[2].set(4.0f, 40.0, 4);
+    UNIT_TEST_COMPARE(table.getRow(2).get<id>(), 4);
+
+    // Testing StructOfArrays::remove (the last row fills the hole)
+    table.remove(0);
+    UNIT_TEST_COMPARE(table.getSize(), 2);
+    UNIT_TEST_COMPARE(table[0].get<id>(), 4);
+    UNIT_TEST_COMPARE(table[0].get<x>(), 4.0f);
+    UNIT_TEST_COMPARE(table[1].get<id>(), 2);
+    table.remove(1);
+    UNIT_TEST_COMPARE(table.getSize(), 1);
+
+    // Testing StructOfArrays (full)
+    table.append(5.0f, 50.0, 5);
+    table.append(6.0f, 60.0, 6);
+    table.append(7.0f, 70.0, 7);
+    UNIT_TEST_ASSERT(table.tryAppend(8.0f, 80.0, 8) == System::Status::out_of_range);
+    uint8_t ids = 0;
+    for (uint8_t value : table.getColumn<id>()){
+        ids += value;
+    }
+    UNIT_TEST_COMPARE(ids, 4 + 5 + 6 + 7);
+
+    // Testing StructOfArrays::remove and StructOfArrays::clear (vacated rows release their fields)
+    MemoryManager::StructOfArrays<4, std::shared_ptr<int>> owners;
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    owners.append(shared);
+    owners.append(shared);
+    owners.append(shared);
+    owners.remove(2);
+    UNIT_TEST_COMPARE(shared.use_count(), 3);
+    owners.remove(0);
+    UNIT_TEST_COMPARE(shared.use_count(), 2);
+    owners.clear();
+    UNIT_TEST_COMPARE(shared.use_count(), 1);
+}
+UNIT_TEST_END
+
+UNIT_TEST_BEGIN
 {
-    UnitTest::run(false);
-    return 0;
+    using Pool = MemoryManager::MemoryPool<uint32_t, 64>;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/wizardrtoz-snapshot-%d", static_cast<int>(getpid()));
+    unlink(path);
+    size_t position = 0;
+
+    // Testing Snapshot (a new file builds a new pool)
+    {
+        MemoryManager::Snapshot<Pool> snapshot(path);
+        UNIT_TEST_ASSERT(snapshot.attach() == false);
+        UNIT_TEST_COMPARE(snapshot->getFreeSpace(), 64);
+        snapshot->allocate(3).detach();
+        Pool::Reference reference = snapshot->allocate(5);
+        reference[4] = 42;
+        position = reference.getPosition();
+        reference.detach();
+        UNIT_TEST_COMPARE(reference.getPosition(), 64);
+        UNIT_TEST_COMPARE(Pool::Reference().getPosition(), 64);
+        snapshot.snapshot();
+    }
+
+    // Testing Snapshot::attach (the pool is restored and its blocks adopted again)
+    {
+        MemoryManager::Snapshot<Pool> snapshot(path);
+        UNIT_TEST_ASSERT(snapshot.attach(true));
+        UNIT_TEST_COMPARE(snapshot->getFreeSpace(), 56);
+        UNIT_TEST_COMPARE(position, 3);
+        Pool::Reference reference = snapshot->adopt(position, 5);
+        UNIT_TEST_COMPARE(reference[4], 42);
+        reference.release();
+        UNIT_TEST_COMPARE(snapshot->getFreeSpace(), 61);
+        UNIT_TEST_ASSERT(snapshot->adopt(position, 5).isEmpty());
+        UNIT_TEST_ASSERT(snapshot->adopt(64, 1).isEmpty());
+    }
+
+    // Testing Snapshot::attach (changes after the last snapshot make the file unclean)
+    {
+        MemoryManager::Snapshot<Pool> snapshot(path);
+        UNIT_TEST_ASSERT(snapshot.attach() == false);
+        UNIT_TEST_COMPARE(snapshot->getFreeSpace(), 64);
+        snapshot.snapshot();
+    }
+
+    // Testing Snapshot::snapshot (a change through the object afterwards makes the file unclean)
+    {
+        MemoryManager::Snapshot<Pool> snapshot(path);
+        UNIT_TEST_ASSERT(snapshot.attach());
+        snapshot.snapshot();
+        snapshot->allocate(2).detach();
+    }
+    {
+        MemoryManager::Snapshot<Pool> snapshot(path);
+        UNIT_TEST_ASSERT(snapshot.attach() == false);
+    }
+
+    // Testing Snapshot::attach (another layout version)
+    {
+        MemoryManager::Snapshot<Pool> snapshot(path, 2);
+        UNIT_TEST_ASSERT(snapshot.attach() == false);
+    }
+    unlink(path);
+}
+UNIT_TEST_END
+
+UNIT_BENCH_BEGIN("Bitwise::Bit::set")
+{
+    uint64_t data = 0;
+    uint8_t position = 0;
+    UNIT_BENCH_MEASURE {
+        MemoryManager::Bitwise<uint64_t>::Bit::set(data, position, 3);
+        position = (position + 7) & 31;
+        UnitTest::doNotOptimize(data);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Bitwise::Bit::read")
+{
+    uint64_t data = 0xAABBCCDDEEFF;
+    uint8_t position = 0;
+    UNIT_BENCH_MEASURE {
+        uint16_t value = 0;
+        MemoryManager::Bitwise<uint64_t>::Bit::read(value, data, position, 12);
+        position = (position + 5) & 31;
+        UnitTest::doNotOptimize(value);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("BitArray::get")
+{
+    MemoryManager::BitArray<1024> bit_array;
+    size_t position = 0;
+    UNIT_BENCH_MEASURE {
+        uint8_t value = bit_array.get<uint8_t>(position, 5);
+        position = (position + 13) & 1015;
+        UnitTest::doNotOptimize(value);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("BitArray::write")
+{
+    MemoryManager::BitArray<1024> bit_array;
+    size_t position = 0;
+    UNIT_BENCH_MEASURE {
+        bit_array.write(position, position, 5);
+        position = (position + 13) & 1015;
+        UnitTest::clobberMemory();
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("BitArray::any (64 bits)")
+{
+    MemoryManager::BitArray<1024> bit_array;
+    size_t position = 0;
+    UNIT_BENCH_MEASURE {
+        bool value = bit_array.any(position, 64);
+        position = (position + 13) & 511;
+        UnitTest::doNotOptimize(value);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("BitArray::fill (64 bits)")
+{
+    MemoryManager::BitArray<1024> bit_array;
+    size_t position = 0;
+    UNIT_BENCH_MEASURE {
+        bit_array.fill(position, 64, position & 1);
+        position = (position + 13) & 511;
+        UnitTest::clobberMemory();
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryPool::allocate/free")
+{
+    static MemoryManager::MemoryPool<uint32_t, 256> pool;
+    UNIT_BENCH_MEASURE {
+        auto reference = pool.allocate(4);
+        UnitTest::doNotOptimize(reference.begin());
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryPool::tryAllocate/free")
+{
+    static MemoryManager::MemoryPool<uint32_t, 256> pool;
+    MemoryManager::MemoryPool<uint32_t, 256>::Reference reference;
+    UNIT_BENCH_MEASURE {
+        System::Status status = pool.tryAllocate(reference, 4);
+        UnitTest::doNotOptimize(status);
+        reference.release();
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryPool::getData")
+{
+    static MemoryManager::MemoryPool<uint32_t, 256> pool;
+    size_t position = 0;
+    UNIT_BENCH_MEASURE {
+        uint32_t value = pool.getData(position);
+        position = (position + 1) & 255;
+        UnitTest::doNotOptimize(value);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("MemoryPool::tryGetData")
+{
+    static MemoryManager::MemoryPool<uint32_t, 256> pool;
+    size_t position = 0;
+    UNIT_BENCH_MEASURE {
+        uint32_t* value = nullptr;
+        System::Status status = pool.tryGetData(value, position);
+        position = (position + 1) & 255;
+        UnitTest::doNotOptimize(status);
+        UnitTest::doNotOptimize(value);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("StaticList::append/remove")
+{
+    MemoryManager::StaticList<int> list;
+    int values[8] = {0};
+    MemoryManager::StaticList<int>::Element elements[8] = {
+        {values[0], 3}, {values[1], 1}, {values[2], 4}, {values[3], 1},
+        {values[4], 5}, {values[5], 9}, {values[6], 2}, {values[7], 6},
+    };
+    for (size_t index = 0 ; index < 7 ; index++){
+        list.append(elements[index]);
+    }
+    UNIT_BENCH_MEASURE {
+        size_t position = list.append(elements[7]);
+        UnitTest::doNotOptimize(position);
+        list.remove(elements[7]);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("SharedMemoryPool::allocate/free")
+{
+    static MemoryManager::SharedMemoryPool<uint32_t, 256> pool;
+    UNIT_BENCH_MEASURE {
+        auto reference = pool.allocate(4);
+        UnitTest::doNotOptimize(reference.begin());
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("SlotMap::insert/erase")
+{
+    static MemoryManager::SlotMap<uint32_t, 256> slot_map;
+    for (uint32_t index = 0 ; index < 128 ; index++){
+        slot_map.insert(index);
+    }
+    UNIT_BENCH_MEASURE {
+        auto handle = slot_map.insert(7);
+        UnitTest::doNotOptimize(handle);
+        slot_map.erase(handle);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("SlotMap::get")
+{
+    static MemoryManager::SlotMap<uint32_t, 256> slot_map;
+    MemoryManager::SlotMap<uint32_t, 256>::Handle handles[256];
+    for (uint32_t index = 0 ; index < 256 ; index++){
+        handles[index] = slot_map.insert(index);
+    }
+    size_t position = 0;
+    UNIT_BENCH_MEASURE {
+        uint32_t* value = slot_map.get(handles[position]);
+        position = (position + 1) & 255;
+        UnitTest::doNotOptimize(value);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("StaticHashMap::insert/erase")
+{
+    static MemoryManager::StaticHashMap<uint32_t, uint32_t, 256> map;
+    for (uint32_t key = 0 ; key < 128 ; key++){
+        map.insert(key * 3, key);
+    }
+    uint32_t key = 1;
+    UNIT_BENCH_MEASURE {
+        uint32_t* value = map.insert(key, key);
+        UnitTest::doNotOptimize(value);
+        map.erase(key);
+        key = (key + 3) | 1;
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("StaticHashMap::find")
+{
+    static MemoryManager::StaticHashMap<uint32_t, uint32_t, 256> map;
+    for (uint32_t key = 0 ; key < 128 ; key++){
+        map.insert(key * 3, key);
+    }
+    uint32_t key = 0;
+    UNIT_BENCH_MEASURE {
+        uint32_t* value = map.find(key * 3);
+        key = (key + 1) & 127;
+        UnitTest::doNotOptimize(value);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("StructOfArrays::getColumn (sum)")
+{
+    static MemoryManager::StructOfArrays<1024, uint32_t, uint32_t, float> table;
+    for (uint32_t index = 0 ; index < 1024 ; index++){
+        table.append(index, index * 2, 1.0f);
+    }
+    UNIT_BENCH_MEASURE {
+        auto column = table.getColumn<1>();
+        uint32_t sum = 0;
+        for (uint32_t value : column){
+            sum += value;
+        }
+        UnitTest::doNotOptimize(sum);
+    }
+}
+UNIT_BENCH_END
+
+UNIT_BENCH_BEGIN("Snapshot::snapshot (4 KiB)")
+{
+    const char* path = "/tmp/wizardrtoz-snapshot-bench";
+    MemoryManager::Snapshot<MemoryManager::BitArray<32768>> snapshot(path);
+    snapshot.attach();
+    size_t position = 0;
+    UNIT_BENCH_MEASURE {
+        snapshot->write(position, position, 8);
+        snapshot.snapshot();
+        position = (position + 8) & 32767;
+    }
+    unlink(path);
+}
+UNIT_BENCH_END
+
+/*
+ * Without arguments every test runs in this process. --isolated [filter] runs the tests whose
+ * name contains filter in their own processes, --jobs <n> at a time and killed after
+ * --timeout <ms>. With --bench [filter] the benchmarks run instead; --json <path> writes their
+ * results and --baseline <path> compares them with an earlier --json file, failing the run on
+ * regressions.
+ */
+int main(int argc, char** argv)
+{
+    bool benchmark = false;
+    bool isolated = false;
+    size_t amount_of_workers = 0;
+    uint32_t timeout = 10000;
+    const char* filter = nullptr;
+    const char* json_path = nullptr;
+    const char* baseline_path = nullptr;
+    for (int index = 1 ; index < argc ; index++){
+        if (strcmp(argv[index], "--bench") == 0){
+            benchmark = true;
+        } else if (strcmp(argv[index], "--isolated") == 0){
+            isolated = true;
+        } else if (strcmp(argv[index], "--jobs") == 0 && index + 1 < argc){
+            amount_of_workers = strtoul(argv[++index], nullptr, 10);
+        } else if (strcmp(argv[index], "--timeout") == 0 && index + 1 < argc){
+            timeout = strtoul(argv[++index], nullptr, 10);
+        } else if (strcmp(argv[index], "--json") == 0 && index + 1 < argc){
+            json_path = argv[++index];
+        } else if (strcmp(argv[index], "--baseline") == 0 && index + 1 < argc){
+            baseline_path = argv[++index];
+        } else {
+            filter = argv[index];
+        }
+    }
+    if (isolated){
+        return UnitTest::runIsolated(amount_of_workers, timeout, filter) == 0 ? 0 : 1;
+    }
+    if (benchmark == false){
+        UnitTest::run(false);
+        return 0;
+    }
+
+    int json_descriptor = -1;
+    if (json_path != nullptr){
+        json_descriptor = open(json_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (json_descriptor < 0){
+            UnitTest::log("[x] Could not open %s.\r\n", json_path);
+            return 1;
+        }
+    }
+    System::FileSink json(json_descriptor);
+    size_t regressions = UnitTest::bench(filter, json_descriptor < 0 ? nullptr : &json, baseline_path);
+    if (json_descriptor >= 0){
+        close(json_descriptor);
+    }
+    return regressions == 0 ? 0 : 1;
 }